@@ -0,0 +1,364 @@
+// Streaming level art through AssetStore.
+//
+// Builds a small pack in RAM in the sgfasset --pack layout, standing in for
+// external flash (a game writes it with `sgfasset --pack` and reads it with
+// FlashBlockDevice or FileBlockDevice). Three levels then run for 40 frames
+// each. Every level scene queues prefetch hints for its first tilemap chunks
+// and its enemy sprite in onEnter(), and for the next chunk while scrolling;
+// the enemy is bound by handle (the hero stays bound for the whole run) and
+// the visible chunks are fetched every frame. One line per frame:
+//
+//   frame,level,hits,misses,bytes_read,prefetch_bytes,hit_pct
+//
+// followed by checks of the decoded data (check,status) and the totals.
+// Build with SGF_ASSET_PREFETCH=0 to drop the hints and compare the misses.
+
+#include <Arduino.h>
+
+#include "SGF/AssetStore.h"
+#include "SGF/BlockDevice.h"
+#include "SGF/Scene.h"
+#include "SGF/Sprites.h"
+
+#ifndef SGF_ASSET_PREFETCH
+#define SGF_ASSET_PREFETCH 1
+#endif
+
+namespace {
+
+constexpr int kLevels = 3;
+constexpr int kChunksPerLevel = 6;
+constexpr int kChunkTiles = 16;  // 16 x 16 tile indices per chunk
+constexpr int kTilePx = 4;
+constexpr int kChunkPx = kChunkTiles * kTilePx;
+constexpr int kViewW = 128;
+constexpr int kFramesPerLevel = 40;
+constexpr int kHeroSize = 16;
+constexpr int kEnemySize = 24;
+constexpr uint16_t kKey = 0xF81F;
+
+// Handles, in pack order.
+constexpr AssetHandle kHero = 0;
+constexpr AssetHandle kFirstEnemy = 1;
+constexpr AssetHandle kFirstChunk = kFirstEnemy + kLevels;
+constexpr int kAssetCount = kFirstChunk + kLevels * kChunksPerLevel;
+
+AssetHandle chunkHandle(int level, int chunk) { return (AssetHandle)(kFirstChunk + level * kChunksPerLevel + chunk); }
+
+// --- Source art ---------------------------------------------------------------
+
+bool heroOpaque(int x, int y) {
+  const int dx = 2 * x - (kHeroSize - 1);
+  const int dy = 2 * y - (kHeroSize - 1);
+  return dx * dx + dy * dy <= (kHeroSize - 1) * (kHeroSize - 1);
+}
+
+uint16_t heroPixel(int x, int y) { return heroOpaque(x, y) ? (uint16_t)(0x0841u * (x + y) + 0x1000u) : kKey; }
+
+uint8_t enemyIndex(int level, int x, int y) {
+  if (x < 2 || y < 2 || x >= kEnemySize - 2 || y >= kEnemySize - 2) return 0;
+  return (uint8_t)(1 + ((x / 4 + y / 4 + level) % 3));
+}
+
+uint16_t enemyPalette(int level, int index) {
+  static const uint16_t kColors[4] = {kKey, 0xF800, 0x07E0, 0x001F};
+  return index == 0 ? kColors[0] : (uint16_t)(kColors[index] ^ (uint16_t)(level * 0x0421u));
+}
+
+uint8_t chunkTile(int level, int chunk, int i) { return (uint8_t)((i * 7 + chunk * 13 + level * 31) & 0x3F); }
+
+// --- Pack image (sgfasset --pack layout) ---------------------------------------
+
+uint8_t packImage[16384];
+uint32_t packSize = 0;
+
+void put16(uint8_t* p, uint32_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+void put32(uint8_t* p, uint32_t v) {
+  put16(p, v & 0xFFFF);
+  put16(p + 2, v >> 16);
+}
+
+void writeEntry(AssetHandle h, uint32_t offset, uint32_t stored, uint32_t decoded, int w, int hgt, uint16_t key,
+                int paletteSize, int spanBytes, uint8_t kind, uint8_t format) {
+  uint8_t* e = packImage + AssetStore::kHeaderBytes + h * AssetStore::kEntryBytes;
+  put32(e, offset);
+  put32(e + 4, stored);
+  put32(e + 8, decoded);
+  put16(e + 12, (uint32_t)w);
+  put16(e + 14, (uint32_t)hgt);
+  put16(e + 16, 1);
+  put16(e + 18, (uint32_t)(w / 2));
+  put16(e + 20, (uint32_t)(hgt - 1));
+  put16(e + 22, key);
+  put16(e + 24, (uint32_t)paletteSize);
+  put16(e + 26, (uint32_t)spanBytes);
+  e[28] = kind;
+  e[29] = format;
+  e[30] = 0;
+  e[31] = kind == 0 ? 1 : 0;
+}
+
+void buildPack() {
+  memcpy(packImage, "SGFP", 4);
+  put16(packImage + 4, AssetStore::kVersion);
+  put16(packImage + 6, kAssetCount);
+  put32(packImage + 8, AssetStore::kHeaderBytes);
+  put32(packImage + 12, 0);
+  uint32_t pos = AssetStore::kHeaderBytes + kAssetCount * AssetStore::kEntryBytes;
+
+  // Hero: Rgb565 with one opaque run per row.
+  const uint32_t heroAt = pos;
+  for (int y = 0; y < kHeroSize; ++y) {
+    for (int x = 0; x < kHeroSize; ++x, pos += 2) put16(packImage + pos, heroPixel(x, y));
+  }
+  const uint32_t spansAt = pos;
+  uint32_t n = kHeroSize + 1;
+  for (int y = 0; y < kHeroSize; ++y) {
+    put16(packImage + spansAt + 2 * y, n);
+    int first = 0;
+    while (first < kHeroSize && !heroOpaque(first, y)) first++;
+    int last = kHeroSize - 1;
+    while (last >= first && !heroOpaque(last, y)) last--;
+    if (last >= first) {
+      put16(packImage + spansAt + 2 * n, (uint32_t)first);
+      put16(packImage + spansAt + 2 * n + 2, (uint32_t)(last - first + 1));
+      n += 2;
+    }
+  }
+  put16(packImage + spansAt + 2 * kHeroSize, n);
+  pos += 2 * n;
+  writeEntry(kHero, heroAt, pos - heroAt, pos - heroAt, kHeroSize, kHeroSize, kKey, 0, (int)(2 * n), 0, 0);
+
+  // Enemies: Indexed4, 4 colours.
+  for (int level = 0; level < kLevels; ++level) {
+    const uint32_t at = pos;
+    for (int i = 0; i < 4; ++i, pos += 2) put16(packImage + pos, enemyPalette(level, i));
+    for (int y = 0; y < kEnemySize; ++y) {
+      for (int x = 0; x < kEnemySize; x += 2) {
+        packImage[pos++] = (uint8_t)((enemyIndex(level, x, y) << 4) | enemyIndex(level, x + 1, y));
+      }
+    }
+    writeEntry((AssetHandle)(kFirstEnemy + level), at, pos - at, kEnemySize * kEnemySize * 2, kEnemySize, kEnemySize,
+               kKey, 4, 0, 0, 2);
+  }
+
+  // Tilemap chunks: raw tile indices.
+  for (int level = 0; level < kLevels; ++level) {
+    for (int c = 0; c < kChunksPerLevel; ++c) {
+      const uint32_t at = pos;
+      for (int i = 0; i < kChunkTiles * kChunkTiles; ++i) packImage[pos++] = chunkTile(level, c, i);
+      writeEntry(chunkHandle(level, c), at, pos - at, pos - at, kChunkTiles, kChunkTiles, 0, 0, 0, 1, 0);
+    }
+  }
+  packSize = pos;
+}
+
+// --- Store and scenes ------------------------------------------------------------
+
+alignas(4) uint8_t cacheArena[5120];
+AssetStore::Entry directory[kAssetCount];
+MemoryBlockDevice flash(packImage, sizeof(packImage));
+AssetStore store(flash, directory, kAssetCount, cacheArena, sizeof(cacheArena), 512);
+
+SpriteLayer sprites;
+uint16_t regionBuf[64 * 48];
+volatile uint32_t sink = 0;
+
+class LevelScene : public Scene {
+public:
+  explicit LevelScene(int level) : level(level) {}
+
+  void onEnter() override {
+    frame = 0;
+    bound = false;
+#if SGF_ASSET_PREFETCH
+    store.prefetch(kFirstEnemy + level);
+    for (int c = 0; c < 3; ++c) store.prefetch(chunkHandle(level, c));
+#endif
+  }
+
+  void onExit() override {
+    store.unbind(kFirstEnemy + level);
+    sprites.sprite(1).active = false;
+  }
+
+  void onPhysics(float delta) override { (void)delta; }
+
+  void onProcess(float delta) override {
+    (void)delta;
+    if (!bound) {
+      bound = true;
+      sprites.sprite(1).active = store.bindSprite(kFirstEnemy + level, sprites.sprite(1));
+    }
+
+    // Widoczne fragmenty mapy przy przewijaniu w prawo.
+    const int camX = frame * ((kChunksPerLevel * kChunkPx - kViewW) / kFramesPerLevel);
+    const int lastVisible = (camX + kViewW - 1) / kChunkPx;
+    for (int c = camX / kChunkPx; c <= lastVisible && c < kChunksPerLevel; ++c) {
+      const uint8_t* tiles = store.data(chunkHandle(level, c));
+      if (tiles) sink += tiles[(frame * 5) % (kChunkTiles * kChunkTiles)];
+    }
+#if SGF_ASSET_PREFETCH
+    // Następny fragment wczytuje się z wyprzedzeniem, zanim wjedzie na ekran.
+    if (lastVisible + 1 < kChunksPerLevel) store.prefetch(chunkHandle(level, lastVisible + 1));
+#endif
+    sprites.sprite(0).setPosition(20 + frame % 8, 40);
+    sprites.sprite(1).setPosition(44, 40);
+    sprites.renderRegion(0, 0, 64, 48, regionBuf);
+    sink += regionBuf[40 * 64 + 28];
+    frame++;
+  }
+
+private:
+  int level;
+  int frame = 0;
+  bool bound = false;
+};
+
+LevelScene levels[kLevels] = {LevelScene(0), LevelScene(1), LevelScene(2)};
+SceneSwitcher switcher;
+
+int checks = 0;
+int failures = 0;
+
+void report(const char* check, bool ok) {
+  checks++;
+  if (!ok) failures++;
+  Serial.print(check);
+  Serial.print(',');
+  Serial.println(ok ? "ok" : "FAIL");
+}
+
+void printFrame(int frame, int level) {
+  const AssetStore::Stats& s = store.frameStats();
+  Serial.print(frame);
+  Serial.print(',');
+  Serial.print(level);
+  Serial.print(',');
+  Serial.print(s.hits);
+  Serial.print(',');
+  Serial.print(s.misses);
+  Serial.print(',');
+  Serial.print(s.bytesRead);
+  Serial.print(',');
+  Serial.print(s.prefetchBytes);
+  Serial.print(',');
+  Serial.println(s.hitRateX100() / 100);
+}
+
+void runChecks() {
+  store.beginFrame();
+  SpriteAsset hero;
+  bool ok = store.asset(kHero, &hero) && hero.opaqueSpans && hero.keyed && hero.transparent == kKey;
+  for (int y = 0; ok && y < kHeroSize; ++y) {
+    for (int x = 0; x < kHeroSize; ++x) ok = ok && hero.pixels565[y * kHeroSize + x] == heroPixel(x, y);
+  }
+  report("hero_pixels", ok);
+
+  for (int level = 0; level < kLevels; ++level) {
+    store.beginFrame();  // two enemies and the hero fill the cache
+    SpriteAsset enemy;
+    ok = store.asset(kFirstEnemy + level, &enemy) && enemy.format == SpriteAsset::Format::Rgb565;
+    for (int y = 0; ok && y < kEnemySize; ++y) {
+      for (int x = 0; x < kEnemySize; ++x) {
+        ok = ok && enemy.pixels565[y * kEnemySize + x] == enemyPalette(level, enemyIndex(level, x, y));
+      }
+    }
+    report("enemy_indexed4_decode", ok);
+  }
+
+  ok = true;
+  for (int c = 0; c < kChunksPerLevel; ++c) {
+    store.beginFrame();
+    const uint8_t* tiles = store.data(chunkHandle(1, c));
+    for (int i = 0; ok && i < kChunkTiles * kChunkTiles; ++i) ok = tiles && tiles[i] == chunkTile(1, c, i);
+  }
+  report("chunk_bytes", ok);
+
+  // Przypięty zasób nie może się ruszyć mimo wypychania całej reszty.
+  store.beginFrame();
+  SpriteLayer::Sprite s;
+  store.bindSprite(kHero, s);
+  const uint16_t* pinned = s.pixels565;
+  for (int level = 0; level < kLevels; ++level) {
+    for (int c = 0; c < kChunksPerLevel; ++c) {
+      store.beginFrame();
+      store.data(chunkHandle(level, c));
+      store.data(kFirstEnemy + level);
+    }
+  }
+  SpriteAsset again;
+  report("pinned_stays", store.asset(kHero, &again) && again.pixels565 == pinned);
+  store.unbind(kHero);
+
+  // Wszystkie fragmenty naraz w tej samej klatce się nie zmieszczą.
+  store.beginFrame();
+  int loaded = 0;
+  for (int c = 0; c < kLevels * kChunksPerLevel; ++c) loaded += store.data(kFirstChunk + c) ? 1 : 0;
+  store.beginFrame();
+  report("frame_working_set_protected", loaded == store.slotCount() && store.frameStats().failures > 0);
+
+  AssetStore::Entry tooSmall[2];
+  AssetStore bad(flash, tooSmall, 2, cacheArena, sizeof(cacheArena), 512);
+  report("directory_capacity", !bad.open());
+}
+
+}  // namespace
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {
+  }
+  buildPack();
+  Serial.print("# pack_bytes=");
+  Serial.print(packSize);
+  Serial.print(" cache_slots=");
+  Serial.println(store.open() ? store.slotCount() : -1);
+
+  Serial.println("frame,level,hits,misses,bytes_read,prefetch_bytes,hit_pct");
+  // Bohater jest we wszystkich poziomach: przypięty na stałe.
+  sprites.sprite(0).active = store.bindSprite(kHero, sprites.sprite(0));
+  switcher.setInitial(levels[0]);
+  for (int frame = 0; frame < kLevels * kFramesPerLevel; ++frame) {
+    const int level = frame / kFramesPerLevel;
+    if (frame > 0 && frame % kFramesPerLevel == 0) switcher.switchTo(levels[level]);
+    store.beginFrame();
+    if (frame > 0) printFrame(frame - 1, (frame - 1) / kFramesPerLevel);
+    switcher.onPhysics(1.0f / 30.0f);
+    switcher.onProcess(1.0f / 30.0f);
+  }
+  store.beginFrame();
+  printFrame(kLevels * kFramesPerLevel - 1, kLevels - 1);
+
+  const AssetStore::Stats& t = store.totals();
+  Serial.print("# frames=");
+  Serial.print(t.frames);
+  Serial.print(" hits=");
+  Serial.print(t.hits);
+  Serial.print(" misses=");
+  Serial.print(t.misses);
+  Serial.print(" hit_pct=");
+  Serial.print(t.hitRateX100() / 100);
+  Serial.print(" bytes_read=");
+  Serial.print(t.bytesRead);
+  Serial.print(" prefetch_bytes=");
+  Serial.print(t.prefetchBytes);
+  Serial.print(" evictions=");
+  Serial.println(t.evictions);
+
+  levels[kLevels - 1].onExit();
+  store.unbind(kHero);
+  store.evictAll();
+  Serial.println("check,status");
+  runChecks();
+  Serial.print("# checks=");
+  Serial.print(checks);
+  Serial.print(" failures=");
+  Serial.println(failures);
+}
+
+void loop() {}
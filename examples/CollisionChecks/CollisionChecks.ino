@@ -0,0 +1,197 @@
+// Host-checkable TileGrid queries.
+//
+// Sweeps boxes through seeded random 12x10 levels (8x8 tiles, solid
+// outside) and checks that no sweep ends overlapping a solid tile or beyond
+// its own motion, that single-axis sweeps stop exactly where a one-unit
+// stepping reference stops, and that diagonal moves hitting a tile corner
+// exactly (both leading edges crossing at once) are resolved. Each check
+// prints:
+//
+//   check,status
+
+#include <Arduino.h>
+
+#include "SGF/Collision.h"
+
+namespace {
+
+constexpr int COLS = 12;
+constexpr int ROWS = 10;
+constexpr int TILE = 8;
+constexpr int32_t ONE = 1 << TileGrid::kFracBits;
+constexpr int32_t TILE_FX = TILE * ONE;
+
+int checks = 0;
+int failures = 0;
+
+void report(const char* check, bool ok) {
+  checks++;
+  if (!ok) failures++;
+  Serial.print(check);
+  Serial.print(',');
+  Serial.println(ok ? "ok" : "FAIL");
+}
+
+struct Rng {
+  uint32_t state;
+
+  explicit Rng(uint32_t seed) : state(seed ? seed : 1u) {}
+
+  uint32_t next() {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+  }
+
+  int range(int lo, int hi) { return lo + (int)(next() % (uint32_t)(hi - lo + 1)); }
+};
+
+uint8_t level[ROWS * ((COLS + 7) / 8)];
+
+void setSolid(int col, int row) { level[row * ((COLS + 7) / 8) + (col >> 3)] |= (uint8_t)(0x80u >> (col & 7)); }
+
+void randomLevel(Rng& rng, int percent) {
+  memset(level, 0, sizeof(level));
+  for (int r = 0; r < ROWS; r++) {
+    for (int c = 0; c < COLS; c++) {
+      if (rng.range(0, 99) < percent) setSolid(c, r);
+    }
+  }
+}
+
+int floorDiv(int32_t a, int32_t b) { return (int)(a >= 0 ? a / b : -((-a + b - 1) / b)); }
+
+// Box of w x h pixels at 24.8 (x, y) overlaps a solid tile.
+bool overlaps(const TileGrid& grid, int32_t x, int32_t y, int w, int h) {
+  const int c0 = floorDiv(x, TILE_FX);
+  const int c1 = floorDiv(x + w * ONE - 1, TILE_FX);
+  const int r0 = floorDiv(y, TILE_FX);
+  const int r1 = floorDiv(y + h * ONE - 1, TILE_FX);
+  for (int r = r0; r <= r1; r++) {
+    for (int c = c0; c <= c1; c++) {
+      if (grid.solidTile(c, r)) return true;
+    }
+  }
+  return false;
+}
+
+bool within(int32_t v, int32_t from, int32_t d) { return d >= 0 ? (v >= from && v <= from + d) : (v <= from && v >= from + d); }
+
+// One unit at a time along a single axis.
+int32_t stepReference(const TileGrid& grid, int32_t x, int32_t y, int w, int h, int32_t dx, int32_t dy) {
+  const int32_t sx = dx > 0 ? 1 : dx < 0 ? -1 : 0;
+  const int32_t sy = dy > 0 ? 1 : dy < 0 ? -1 : 0;
+  int32_t n = dx ? (dx < 0 ? -dx : dx) : (dy < 0 ? -dy : dy);
+  while (n-- > 0) {
+    if (overlaps(grid, x + sx, y + sy, w, h)) break;
+    x += sx;
+    y += sy;
+  }
+  return dx ? x : y;
+}
+
+// Random free start, random move; the result must be free and on the way.
+void checkFuzz() {
+  Rng rng(0xC011u);
+  TileGrid grid(level, COLS, ROWS, TILE, TILE);
+  int sweeps = 0;
+  int bad = 0;
+  int axisBad = 0;
+  for (int lv = 0; lv < 200; lv++) {
+    randomLevel(rng, rng.range(5, 40));
+    for (int k = 0; k < 400; k++) {
+      const int w = rng.range(1, 20);
+      const int h = rng.range(1, 20);
+      const int32_t x = rng.range(0, COLS * TILE_FX - w * ONE);
+      const int32_t y = rng.range(0, ROWS * TILE_FX - h * ONE);
+      if (overlaps(grid, x, y, w, h)) continue;
+      int32_t dx = rng.range(-24 * ONE, 24 * ONE);
+      int32_t dy = rng.range(-24 * ONE, 24 * ONE);
+      switch (rng.range(0, 5)) {
+        case 0: dx = 0; break;
+        case 1: dy = 0; break;
+        case 2: dy = (rng.next() & 1) ? dx : -dx; break;  // 45 degrees
+        case 3: dy = dx / 2; break;
+        default: break;
+      }
+      const TileGrid::Sweep s = grid.sweep(x, y, w, h, dx, dy);
+      sweeps++;
+      if (overlaps(grid, s.x, s.y, w, h) || !within(s.x, x, dx) || !within(s.y, y, dy)) bad++;
+      if ((dx == 0) != (dy == 0)) {
+        const int32_t ref = stepReference(grid, x, y, w, h, dx, dy);
+        if ((dx ? s.x : s.y) != ref) axisBad++;
+      }
+    }
+  }
+  report("sweep_fuzz_free_and_on_path", bad == 0 && sweeps > 0);
+  report("sweep_fuzz_single_axis_matches_reference", axisBad == 0);
+}
+
+void checkCorners() {
+  // Reported case: both leading edges reach row -1 and column 0 on the
+  // same step of a 45 degree move in an empty level.
+  memset(level, 0, sizeof(level));
+  TileGrid grid(level, COLS, ROWS, TILE, TILE);
+  TileGrid::Sweep s = grid.sweep(2304, 256, 6, 5, -1180, -1180);
+  report("corner_tie_outside", !overlaps(grid, s.x, s.y, 6, 5) && s.y == 0 && s.normalY == 1 && s.hit);
+
+  // A lone solid tile met exactly at its corner stops the vertical motion
+  // and lets the box slide on. The 4 px box starts one unit above and left
+  // of tile (5, 5).
+  setSolid(5, 5);
+  const int32_t x = 5 * TILE_FX - 4 * ONE;
+  const int32_t y = 5 * TILE_FX - 4 * ONE;
+  s = grid.sweep(x, y, 4, 4, 3 * ONE, 3 * ONE);
+  report("corner_tie_lone_tile", !overlaps(grid, s.x, s.y, 4, 4) && s.normalY == -1 && s.normalX == 0 &&
+                                   s.x == x + 3 * ONE && s.y == y);
+
+  // A wall in the entered column blocks X instead, and the box keeps
+  // falling past the free corner row. The 4x12 box spans rows 3..4.
+  memset(level, 0, sizeof(level));
+  setSolid(5, 4);
+  const int32_t tallY = 5 * TILE_FX - 12 * ONE;
+  s = grid.sweep(x, tallY, 4, 12, 3 * ONE, 3 * ONE);
+  report("corner_tie_wall", !overlaps(grid, s.x, s.y, 4, 12) && s.normalX == -1 && s.normalY == 0 && s.x == x &&
+                              s.y == tallY + 3 * ONE);
+
+  // Every tie along a diagonal through a checkerboard.
+  memset(level, 0, sizeof(level));
+  for (int r = 0; r < ROWS; r++) {
+    for (int c = 0; c < COLS; c++) {
+      if ((r + c) & 1) setSolid(c, r);
+    }
+  }
+  bool ok = true;
+  for (int sz = 1; sz <= TILE; sz++) {
+    for (int32_t off = -ONE; off <= ONE; off += ONE / 4) {
+      const int32_t sx = 2 * TILE_FX + (TILE - sz) * ONE / 2 + off;
+      const int32_t sy = 2 * TILE_FX + (TILE - sz) * ONE / 2;
+      if (overlaps(grid, sx, sy, sz, sz)) continue;
+      for (int d = 0; d < 4; d++) {
+        const int32_t dx = (d & 1) ? 20 * ONE : -20 * ONE;
+        const int32_t dy = (d & 2) ? 20 * ONE : -20 * ONE;
+        s = grid.sweep(sx, sy, sz, sz, dx, dy);
+        if (overlaps(grid, s.x, s.y, sz, sz)) ok = false;
+      }
+    }
+  }
+  report("corner_tie_checkerboard", ok);
+}
+
+}  // namespace
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {
+  }
+  Serial.println("check,status");
+  checkFuzz();
+  checkCorners();
+  Serial.print("# checks=");
+  Serial.print(checks);
+  Serial.print(" failures=");
+  Serial.println(failures);
+}
+
+void loop() {}
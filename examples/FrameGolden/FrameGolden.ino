@@ -0,0 +1,436 @@
+// Deterministic frame capture and golden-image regression check.
+//
+// Drives a small Game + SceneSwitcher with a fake clock and scripted input,
+// flushes every frame into an in-memory FrameCapture target and compares the
+// per-frame framebuffer hash with the golden table below. Each frame prints:
+//
+//   frame,hash,pixels_pushed,blits,status
+//
+// Build with SGF_GOLDEN_RECORD=1 to print a fresh golden table instead, and
+// with SGF_GOLDEN_DUMP_PPM=1 to stream each frame as a binary PPM right after
+// its report line. SGF_GOLDEN_TILE_HASH=1 flushes with TileFlusher tile
+// hashing enabled; hashes must still match, only pixels pushed may change.
+// SGF_GOLDEN_WORKERS=N renders tiles on N TileWorkers threads.
+// SGF_GOLDEN_OVERDRAW=1 attaches an OverdrawMap (4x4 cells) to the flusher and
+// prints its summary at the end; =2 also streams the repaint and unchanged
+// heatmaps as binary PPMs after it.
+
+#include <Arduino.h>
+
+#include "SGF/Actions.h"
+#include "SGF/Color565.h"
+#include "SGF/DirtyRects.h"
+#include "SGF/Font5x7.h"
+#include "SGF/FrameCapture.h"
+#include "SGF/Game.h"
+#include "SGF/OverdrawMap.h"
+#include "SGF/Scene.h"
+#include "SGF/Sprites.h"
+#include "SGF/TileFlusher.h"
+#include "SGF/TileWorkers.h"
+
+#ifndef SGF_GOLDEN_RECORD
+#define SGF_GOLDEN_RECORD 0
+#endif
+
+#ifndef SGF_GOLDEN_DUMP_PPM
+#define SGF_GOLDEN_DUMP_PPM 0
+#endif
+
+#ifndef SGF_GOLDEN_TILE_HASH
+#define SGF_GOLDEN_TILE_HASH 0
+#endif
+
+#ifndef SGF_GOLDEN_WORKERS
+#define SGF_GOLDEN_WORKERS 0
+#endif
+
+#ifndef SGF_GOLDEN_OVERDRAW
+#define SGF_GOLDEN_OVERDRAW 0
+#endif
+
+namespace {
+
+constexpr int SCREEN_W = 160;
+constexpr int SCREEN_H = 120;
+constexpr int TILE_W = 32;
+constexpr int TILE_H = 32;
+constexpr uint32_t FRAME_US = 16667u;
+constexpr int FRAME_COUNT = 48;
+
+uint16_t framebuffer[SCREEN_W * SCREEN_H];
+#if SGF_GOLDEN_WORKERS
+uint16_t workerArena[SGF_GOLDEN_WORKERS * TileWorkers::kSlotsPerWorker * TILE_W * TILE_H];
+TileWorkers workers(workerArena, TILE_W * TILE_H, SGF_GOLDEN_WORKERS);
+#else
+uint16_t regionBuf[TILE_W * TILE_H];
+#endif
+#if SGF_GOLDEN_OVERDRAW
+constexpr int OVERDRAW_CELL = 4;
+constexpr int OVERDRAW_CELLS = (SCREEN_W / OVERDRAW_CELL) * (SCREEN_H / OVERDRAW_CELL);
+uint16_t overdrawSent[OVERDRAW_CELLS];
+uint16_t overdrawUnchanged[OVERDRAW_CELLS];
+uint16_t overdrawShadow[SCREEN_W * SCREEN_H];
+uint8_t overdrawKnown[(OVERDRAW_CELLS + 7) / 8];
+OverdrawMap overdraw(SCREEN_W, SCREEN_H, OVERDRAW_CELL, overdrawSent, overdrawUnchanged, overdrawShadow,
+                     overdrawKnown);
+#endif
+#if SGF_GOLDEN_TILE_HASH
+uint32_t tileHashes[(SCREEN_W / TILE_W + 1) * (SCREEN_H / TILE_H + 1)];
+#endif
+FrameCapture capture(framebuffer, SCREEN_W, SCREEN_H);
+
+uint32_t fakeNowUs = 1;
+uint32_t fakeClock() { return fakeNowUs; }
+
+struct InputStep {
+  int frame;
+  bool fire;
+};
+
+// FIRE tap on the title screen, then a second tap during play.
+const InputStep kScript[] = {
+  {4, true},
+  {6, false},
+  {30, true},
+  {31, false},
+};
+
+struct Golden {
+  uint32_t hash;
+  uint32_t pixels;
+};
+
+// Regenerate with SGF_GOLDEN_RECORD=1 when the output changes on purpose.
+const Golden kGolden[FRAME_COUNT] = {
+  {0x14b9e0e5u, 19200u},
+  {0x14b9e0e5u, 0u},
+  {0x14b9e0e5u, 0u},
+  {0x14b9e0e5u, 0u},
+  {0x14b9e0e5u, 0u},
+  {0x14b9e0e5u, 0u},
+  {0x5c4c3935u, 19200u},
+  {0x0216e715u, 156u},
+  {0x7350e515u, 168u},
+  {0x3d43bbb5u, 156u},
+  {0x6da9de35u, 168u},
+  {0xc340b755u, 156u},
+  {0xaa5e3515u, 168u},
+  {0x67af20f5u, 156u},
+  {0x611ba2b5u, 168u},
+  {0x81f14715u, 156u},
+  {0x8f4276d5u, 168u},
+  {0x09238635u, 156u},
+  {0xa7dd7075u, 168u},
+  {0x4d0ea115u, 156u},
+  {0xecceec15u, 168u},
+  {0x089da635u, 156u},
+  {0x38729235u, 168u},
+  {0x31640515u, 156u},
+  {0xc1e42115u, 168u},
+  {0x947bc1b5u, 156u},
+  {0xf60e6635u, 168u},
+  {0x5d4026d5u, 156u},
+  {0x98b0fb15u, 168u},
+  {0xb5c81275u, 156u},
+  {0xa73bffb5u, 168u},
+  {0x94fd1815u, 156u},
+  {0xa73bffb5u, 156u},
+  {0xb5c81275u, 168u},
+  {0x98b0fb15u, 156u},
+  {0x5d4026d5u, 168u},
+  {0xf60e6635u, 156u},
+  {0x947bc1b5u, 168u},
+  {0xc1e42115u, 156u},
+  {0x31640515u, 168u},
+  {0x38729235u, 156u},
+  {0x089da635u, 168u},
+  {0xecceec15u, 156u},
+  {0x4d0ea115u, 168u},
+  {0xa7dd7075u, 156u},
+  {0x09238635u, 168u},
+  {0x8f4276d5u, 156u},
+  {0x81f14715u, 168u},
+};
+
+class MiniGame;
+
+class TitleScene : public Scene {
+public:
+  explicit TitleScene(MiniGame& game) : game(game) {}
+  void onEnter() override;
+  void onPhysics(float delta) override;
+  void onProcess(float delta) override;
+
+private:
+  MiniGame& game;
+};
+
+class PlayScene : public Scene {
+public:
+  explicit PlayScene(MiniGame& game) : game(game) {}
+  void onEnter() override;
+  void onPhysics(float delta) override;
+  void onProcess(float delta) override;
+
+private:
+  MiniGame& game;
+};
+
+class MiniGame : public Game {
+public:
+  MiniGame()
+    : Game(FRAME_US, 4u * FRAME_US),
+      flusher(dirty, TILE_W, TILE_H),
+      titleScene(*this),
+      playScene(*this) {}
+
+  void setFire(bool pressed) { fireDown = pressed; }
+  TileFlusher& tileFlusher() { return flusher; }
+
+private:
+  bool fireDown = false;
+  DigitalAction fireAction;
+  PressReleaseAction fireConfirm;
+  DirtyRects dirty;
+  TileFlusher flusher;
+  SpriteLayer sprites;
+  SceneSwitcher sceneSwitcher;
+  TitleScene titleScene;
+  PlayScene playScene;
+  uint16_t boxPixels[12 * 12];
+  float boxX = 8.0f;
+  float boxVX = 90.0f;
+
+  friend class TitleScene;
+  friend class PlayScene;
+
+  void onSetup() override {
+    for (int i = 0; i < 12 * 12; ++i) {
+      int x = i % 12;
+      int y = i / 12;
+      boxPixels[i] = (x + y) & 4 ? Color565::rgb(64, 200, 255) : Color565::rgb(255, 255, 255);
+    }
+    SpriteLayer::Sprite& s = sprites.sprite(0);
+    s.w = 12;
+    s.h = 12;
+    s.pixels565 = boxPixels;
+    s.transparent = 0;
+
+    fireAction.reset(false);
+    sceneSwitcher.setInitial(titleScene);
+  }
+
+  void onPhysics(float delta) override {
+    fireAction.update(fireDown);
+    sceneSwitcher.onPhysics(delta);
+  }
+
+  void onProcess(float delta) override {
+    sceneSwitcher.onProcess(delta);
+    auto render = [this](int x0, int y0, int w, int h, uint16_t* buf) {
+      renderRegion(x0, y0, w, h, buf);
+    };
+#if SGF_GOLDEN_WORKERS
+    flusher.flush(capture, workers, render);
+#else
+    flusher.flush(capture, regionBuf, render);
+#endif
+  }
+
+  void renderRegion(int x0, int y0, int w, int h, uint16_t* buf) {
+    bool title = sceneSwitcher.current() == &titleScene;
+    uint16_t bg = title ? Color565::rgb(4, 8, 20) : Color565::rgb(0, 0, 0);
+    for (int i = 0; i < w * h; ++i) buf[i] = bg;
+
+    if (title) {
+      static const char* kText = "PRESS FIRE";
+      const int scale = 2;
+      const int tx = (SCREEN_W - Font5x7::textWidth(kText, scale)) / 2;
+      const int ty = 50;
+      for (int yy = 0; yy < h; ++yy) {
+        for (int xx = 0; xx < w; ++xx) {
+          if (Font5x7::textPixel(kText, scale, x0 + xx - tx, y0 + yy - ty)) {
+            buf[yy * w + xx] = Color565::rgb(255, 255, 0);
+          }
+        }
+      }
+      return;
+    }
+    sprites.renderRegion(x0, y0, w, h, buf);
+  }
+
+  void markSpriteDirty() {
+    int x0 = 0;
+    int y0 = 0;
+    int x1 = 0;
+    int y1 = 0;
+    SpriteLayer::spriteBounds(sprites.sprite(0), &x0, &y0, &x1, &y1);
+    dirty.add(x0, y0, x1, y1);
+  }
+};
+
+void TitleScene::onEnter() {
+  game.fireConfirm.reset();
+  game.sprites.sprite(0).active = false;
+  game.dirty.invalidate(capture);
+}
+
+void TitleScene::onPhysics(float delta) {
+  (void)delta;
+  if (game.fireConfirm.update(game.fireAction)) {
+    game.sceneSwitcher.switchTo(game.playScene);
+  }
+}
+
+void TitleScene::onProcess(float delta) {
+  (void)delta;
+}
+
+void PlayScene::onEnter() {
+  game.fireConfirm.reset();
+  game.boxX = 8.0f;
+  game.boxVX = 90.0f;
+  SpriteLayer::Sprite& s = game.sprites.sprite(0);
+  s.active = true;
+  s.setPosition((int)game.boxX, 54);
+  game.dirty.invalidate(capture);
+}
+
+void PlayScene::onPhysics(float delta) {
+  game.markSpriteDirty();
+  game.boxX += game.boxVX * delta;
+  if (game.boxX < 0.0f) {
+    game.boxX = 0.0f;
+    game.boxVX = -game.boxVX;
+  }
+  if (game.boxX > (float)(SCREEN_W - 12)) {
+    game.boxX = (float)(SCREEN_W - 12);
+    game.boxVX = -game.boxVX;
+  }
+  if (game.fireConfirm.update(game.fireAction)) {
+    game.boxVX = -game.boxVX;
+  }
+  game.sprites.sprite(0).setPosition((int)game.boxX, 54);
+  game.markSpriteDirty();
+}
+
+void PlayScene::onProcess(float delta) {
+  (void)delta;
+}
+
+MiniGame game;
+
+#if SGF_GOLDEN_DUMP_PPM || SGF_GOLDEN_OVERDRAW
+void writeSerial(const uint8_t* data, size_t len, void* user) {
+  (void)user;
+  Serial.write(data, len);
+}
+#endif
+
+void printHex(uint32_t v) {
+  static const char kDigits[] = "0123456789abcdef";
+  char out[11] = {'0', 'x'};
+  for (int i = 0; i < 8; ++i) out[2 + i] = kDigits[(v >> (28 - i * 4)) & 0xF];
+  out[10] = '\0';
+  Serial.print(out);
+}
+
+void run() {
+  fakeNowUs = 1;
+  capture.clear(0);
+  game.setClock(fakeClock);
+#if SGF_GOLDEN_WORKERS
+  workers.start();
+#endif
+#if SGF_GOLDEN_TILE_HASH
+  game.tileFlusher().enableTileHashing(tileHashes, (int)(sizeof(tileHashes) / sizeof(tileHashes[0])));
+#endif
+#if SGF_GOLDEN_OVERDRAW
+  game.tileFlusher().setOverdraw(&overdraw);
+#endif
+  game.start();
+
+  int script = 0;
+#if !SGF_GOLDEN_RECORD
+  int failures = 0;
+#endif
+  const int scriptLen = (int)(sizeof(kScript) / sizeof(kScript[0]));
+
+#if SGF_GOLDEN_RECORD
+  Serial.println("const Golden kGolden[FRAME_COUNT] = {");
+#else
+  Serial.println("frame,hash,pixels_pushed,blits,status");
+#endif
+
+  for (int frame = 0; frame < FRAME_COUNT; ++frame) {
+    while (script < scriptLen && kScript[script].frame == frame) {
+      game.setFire(kScript[script].fire);
+      script++;
+    }
+
+    fakeNowUs += FRAME_US;
+    game.loop();
+    FrameCapture::FrameStats st = capture.endFrame();
+#if SGF_GOLDEN_OVERDRAW
+    overdraw.endFrame();
+#endif
+
+#if SGF_GOLDEN_RECORD
+    Serial.print("  {");
+    printHex(st.hash);
+    Serial.print("u, ");
+    Serial.print(st.pixelsPushed);
+    Serial.println("u},");
+#else
+    bool ok = kGolden[frame].hash == st.hash;
+    if (!ok) failures++;
+    Serial.print(st.frame);
+    Serial.print(',');
+    printHex(st.hash);
+    Serial.print(',');
+    Serial.print(st.pixelsPushed);
+    Serial.print(',');
+    Serial.print(st.blits);
+    Serial.print(',');
+    if (ok && kGolden[frame].pixels != st.pixelsPushed) {
+      Serial.println("ok-pixels-changed");
+    } else {
+      Serial.println(ok ? "ok" : "FAIL");
+    }
+#endif
+
+#if SGF_GOLDEN_DUMP_PPM
+    capture.writePPM(writeSerial, nullptr);
+#endif
+  }
+
+#if SGF_GOLDEN_RECORD
+  Serial.println("};");
+#else
+  Serial.print("# frames=");
+  Serial.print(FRAME_COUNT);
+  Serial.print(" failures=");
+  Serial.println(failures);
+#endif
+
+#if SGF_GOLDEN_OVERDRAW
+  Serial.print("# overdraw ");
+  overdraw.writeSummary(writeSerial, nullptr);
+#if SGF_GOLDEN_OVERDRAW >= 2
+  overdraw.writeHeatmapPPM(OverdrawMap::Channel::Repaint, writeSerial, nullptr);
+  overdraw.writeHeatmapPPM(OverdrawMap::Channel::Unchanged, writeSerial, nullptr);
+#endif
+#endif
+}
+
+}  // namespace
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {
+  }
+  run();
+}
+
+void loop() {}
@@ -0,0 +1,224 @@
+// Host-checkable command streams of the PanelDriver instantiations.
+//
+// Every supported panel is driven through a RecordingBus instead of SPI and
+// the recorded commands are checked against its traits: init order, COLMOD,
+// MADCTL, window commands (with the ST7789 RAM offsets), RAMWR byte counts
+// and pixel encoding. Each check prints:
+//
+//   panel,check,status
+//
+// followed by the stream hash of a fixed draw script, so a driver change that
+// alters the bytes on the wire shows up in a diff of the output.
+
+#include <Arduino.h>
+
+#include "SGF/PanelDriver.h"
+#include "SGF/PanelTraits.h"
+#include "SGF/RecordingBus.h"
+
+namespace {
+
+int checks = 0;
+int failures = 0;
+
+void report(const char* panel, const char* check, bool ok) {
+  checks++;
+  if (!ok) failures++;
+  Serial.print(panel);
+  Serial.print(',');
+  Serial.print(check);
+  Serial.print(',');
+  Serial.println(ok ? "ok" : "FAIL");
+}
+
+void printHex(uint32_t v) {
+  static const char kDigits[] = "0123456789abcdef";
+  char out[11] = {'0', 'x'};
+  for (int i = 0; i < 8; ++i) out[2 + i] = kDigits[(v >> (28 - i * 4)) & 0xF];
+  out[10] = '\0';
+  Serial.print(out);
+}
+
+// ILI9341 with the usual 15-byte positive/negative gamma tables in kInit,
+// longer than the driver's command buffer.
+struct PanelILI9341Gamma : PanelILI9341 {
+  static constexpr uint8_t kGammaPos[15] = {0x0F, 0x31, 0x2B, 0x0C, 0x0E, 0x08, 0x4E, 0xF1,
+                                            0x37, 0x07, 0x10, 0x03, 0x0E, 0x09, 0x00};
+  static constexpr uint8_t kGammaNeg[15] = {0x00, 0x0E, 0x14, 0x03, 0x11, 0x07, 0x31, 0xC1,
+                                            0x48, 0x08, 0x0F, 0x0C, 0x31, 0x36, 0x0F};
+  static constexpr uint8_t kInit[] = {
+    0x01, 0 | PanelInit::kDelay, 150,  // SWRESET
+    0x11, 0 | PanelInit::kDelay, 120,  // SLPOUT
+    0x26, 1, 0x01,                     // GAMSET
+    0xE0, 15,                          // PGAMCTRL
+    0x0F, 0x31, 0x2B, 0x0C, 0x0E, 0x08, 0x4E, 0xF1, 0x37, 0x07, 0x10, 0x03, 0x0E, 0x09, 0x00,
+    0xE1, 15 | PanelInit::kDelay,      // NGAMCTRL
+    0x00, 0x0E, 0x14, 0x03, 0x11, 0x07, 0x31, 0xC1, 0x48, 0x08, 0x0F, 0x0C, 0x31, 0x36, 0x0F,
+    10,
+  };
+};
+
+uint32_t fnv1a(const uint8_t* p, size_t n) {
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < n; i++) h = (h ^ p[i]) * 16777619u;
+  return h;
+}
+
+// Long init entries arrive whole: every parameter, in order.
+void checkLongInit() {
+  using Driver = PanelDriver<PanelILI9341Gamma, RecordingBus>;
+  static Driver gfx(-1, -1, -1, -1);
+  RecordingBus& bus = gfx.bus();
+  bus.clear();
+  gfx.begin(40000000u);
+  const int pos = bus.find(0xE0);
+  const int neg = bus.find(0xE1);
+  report("ili9341_gamma", "gamma_pos_params",
+         pos >= 0 && bus[pos].dataBytes == 15 &&
+           bus[pos].dataHash == fnv1a(PanelILI9341Gamma::kGammaPos, 15));
+  report("ili9341_gamma", "gamma_neg_params",
+         neg == pos + 1 && bus[neg].dataBytes == 15 &&
+           bus[neg].dataHash == fnv1a(PanelILI9341Gamma::kGammaNeg, 15));
+  report("ili9341_gamma", "gamma_after_gamset", pos > 0 && bus[pos - 1].cmd == 0x26 && bus[pos - 1].dataBytes == 1);
+}
+
+bool windowIs(const RecordingBus::Entry& e, int a, int b) {
+  return e.paramCount == 4 && e.params[0] == (uint8_t)(a >> 8) && e.params[1] == (uint8_t)a &&
+         e.params[2] == (uint8_t)(b >> 8) && e.params[3] == (uint8_t)b;
+}
+
+// CASET / RASET / RAMWR of the last window in the log.
+template <class Panel>
+bool lastWindowIs(const RecordingBus& bus, int x0, int y0, int x1, int y1, uint32_t pixels) {
+  const int ramwr = bus.count() - 1;
+  if (ramwr < 2 || bus[ramwr].cmd != Panel::kRamwr) return false;
+  const RecordingBus::Entry& caset = bus[ramwr - 2];
+  const RecordingBus::Entry& raset = bus[ramwr - 1];
+  return caset.cmd == Panel::kCaset && raset.cmd == Panel::kRaset && windowIs(caset, x0, x1) &&
+         windowIs(raset, y0, y1) && bus[ramwr].dataBytes == pixels * Panel::Format::kBytes;
+}
+
+template <class Panel>
+void checkPanel(const char* name) {
+  using Driver = PanelDriver<Panel, RecordingBus>;
+  using Format = typename Panel::Format;
+  static Driver gfx(-1, -1, -1, -1);
+  RecordingBus& bus = gfx.bus();
+
+  // Init: sekwencja panelu, potem COLMOD, MADCTL i DISPON.
+  bus.clear();
+  gfx.begin(40000000u);
+  bool initOk = bus.count() > 0 && bus[0].cmd == 0x01;
+  int at = 0;
+  for (size_t i = 0; i + 2 <= sizeof(Panel::kInit);) {
+    const uint8_t n = Panel::kInit[i + 1] & (uint8_t)~PanelInit::kDelay;
+    if (at >= bus.count() || bus[at].cmd != Panel::kInit[i] || bus[at].dataBytes != n) initOk = false;
+    at++;
+    i += 2 + n + ((Panel::kInit[i + 1] & PanelInit::kDelay) ? 1 : 0);
+  }
+  report(name, "init_sequence", initOk);
+  report(name, "colmod",
+         at < bus.count() && bus[at].cmd == 0x3A && bus[at].params[0] == Format::kColMod);
+  report(name, "madctl_default",
+         at + 1 < bus.count() && bus[at + 1].cmd == 0x36 && bus[at + 1].params[0] == Panel::kDefaultRotation);
+  report(name, "dispon_last", bus.count() == at + 3 && bus[at + 2].cmd == 0x29);
+  report(name, "spi_frequency", bus.frequencyHz() == 40000000u);
+
+  // Okno i liczba bajtów RAMWR przy przycinaniu.
+  gfx.screenRotation(Panel::kLandscape);
+  report(name, "landscape_size", gfx.width() == Panel::kWidth && gfx.height() == Panel::kHeight);
+  bus.clear();
+  const uint16_t color = 0xF81Fu;
+  gfx.fillRect565(-4, 10, 24, 6, color);
+  const int dx = Panel::colOffset(Panel::kLandscape);
+  const int dy = Panel::rowOffset(Panel::kLandscape);
+  report(name, "fill_window", lastWindowIs<Panel>(bus, dx, 10 + dy, 19 + dx, 15 + dy, 20 * 6));
+
+  alignas(uint16_t) uint8_t expected[Format::kBytes];
+  Format::encode(&color, 1, expected);
+  const RecordingBus::Entry& ramwr = bus[bus.count() - 1];
+  bool pixelOk = ramwr.paramCount >= Format::kBytes;
+  for (size_t i = 0; pixelOk && i < Format::kBytes; i++) pixelOk = ramwr.params[i] == expected[i];
+  report(name, "fill_pixel_format", pixelOk);
+
+  // Ten sam zakres kolumn: CASET pominięty.
+  bus.clear();
+  gfx.fillRect565(0, 30, 20, 2, color);
+  report(name, "caset_skip", bus.count() == 2 && bus[0].cmd == Panel::kRaset && bus[1].cmd == Panel::kRamwr);
+
+  // Odwrócone orientacje i przesunięcia w pamięci kontrolera.
+  gfx.screenRotation(Panel::kLandscapeFlip);
+  bus.clear();
+  gfx.fillRect565(gfx.width() - 2, gfx.height() - 1, 8, 8, color);
+  {
+    const int fx = Panel::colOffset(Panel::kLandscapeFlip);
+    const int fy = Panel::rowOffset(Panel::kLandscapeFlip);
+    report(name, "flip_window",
+           lastWindowIs<Panel>(bus, gfx.width() - 2 + fx, gfx.height() - 1 + fy, gfx.width() - 1 + fx,
+                               gfx.height() - 1 + fy, 2));
+  }
+
+  gfx.screenRotation(Panel::kPortraitFlip);
+  report(name, "portrait_size", gfx.width() == Panel::kHeight && gfx.height() == Panel::kWidth);
+  bus.clear();
+  gfx.fillRect565(0, 0, 1, 1, color);
+  report(name, "portrait_flip_window",
+         lastWindowIs<Panel>(bus, Panel::colOffset(Panel::kPortraitFlip), Panel::rowOffset(Panel::kPortraitFlip),
+                             Panel::colOffset(Panel::kPortraitFlip), Panel::rowOffset(Panel::kPortraitFlip), 1));
+
+  // Blity: zwykły, w miejscu (RGB666 nie może kodować w buforze wywołującego) i 2x.
+  static uint16_t pix[16 * 8];
+  for (int i = 0; i < 16 * 8; i++) pix[i] = (uint16_t)(i * 523u);
+  gfx.screenRotation(Panel::kLandscape);
+  bus.clear();
+  gfx.blit565(4, 4, 16, 8, pix);
+  report(name, "blit_bytes", lastWindowIs<Panel>(bus, 4 + dx, 4 + dy, 19 + dx, 11 + dy, 16 * 8));
+  const uint32_t blitHash = bus[bus.count() - 1].dataHash;
+
+  bus.clear();
+  gfx.blit565InPlace(4, 4, 16, 8, pix);
+  report(name, "blit_in_place_stream", bus.count() > 0 && bus[bus.count() - 1].dataHash == blitHash);
+  report(name, "blit_in_place_source", Format::kInPlace || pix[1] == 523u);
+  for (int i = 0; i < 16 * 8; i++) pix[i] = (uint16_t)(i * 523u);
+
+  bus.clear();
+  gfx.blit565Scaled2x(2, 2, 16, 8, pix);
+  report(name, "blit_2x_bytes", lastWindowIs<Panel>(bus, 4 + dx, 4 + dy, 35 + dx, 19 + dy, 32 * 16));
+
+  report(name, "cs_held_for_bytes", bus.bytesOutsideSelect() == 0);
+
+  // Stały skrypt rysowania: hash całego strumienia.
+  bus.clear();
+  gfx.fillScreen565(0x0000);
+  gfx.fillRect565(10, 10, 50, 40, 0x07E0);
+  gfx.blit565(100, 60, 16, 8, pix);
+  gfx.blit565Scaled2x(40, 40, 16, 8, pix);
+  gfx.drawCenteredText(100, "SGF", 2, 0xFFFF);
+  Serial.print(name);
+  Serial.print(",stream_hash,");
+  printHex(bus.streamHash());
+  Serial.print(',');
+  Serial.print(bus.bytes());
+  Serial.print(',');
+  Serial.println(gfx.busStats().transactions);
+}
+
+}  // namespace
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {
+  }
+  Serial.println("panel,check,status");
+  checkPanel<PanelILI9341>("ili9341");
+  checkPanel<PanelST7789_240x240>("st7789_240x240");
+  checkPanel<PanelILI9488>("ili9488");
+  checkPanel<PanelILI9341Gamma>("ili9341_gamma");
+  checkLongInit();
+  Serial.print("# checks=");
+  Serial.print(checks);
+  Serial.print(" failures=");
+  Serial.println(failures);
+}
+
+void loop() {}
@@ -0,0 +1,1090 @@
+// Render pipeline benchmark.
+//
+// Runs a fixed set of repeatable scenarios and prints one CSV line per
+// scenario over Serial:
+//
+//   name,ops,ns_per_op,pixels_per_s,heap_bytes
+//
+// All workloads use a seeded PRNG, so the same build produces the same
+// work on every run. Capture the output of two commits and diff them.
+//
+// heap_bytes is only measured when SGF_BENCH_COUNT_HEAP is set to 1 (the
+// host build in extras/host does); otherwise the column prints "-". It
+// replaces the global operator new, so leave it off on cores that already
+// define one.
+
+#include <Arduino.h>
+#include <stdlib.h>
+
+#include "SGF/AnimatedSprite.h"
+#include "SGF/Collision.h"
+#include "SGF/Color565.h"
+#include "SGF/DirtyRects.h"
+#include "SGF/DisplayList.h"
+#include "SGF/EntityStore.h"
+#include "SGF/Font5x7.h"
+#include "SGF/IRenderTarget.h"
+#include "SGF/ParticleSystem.h"
+#include "SGF/Primitives.h"
+#include "SGF/RectFlashAnim.h"
+#include "SGF/SpriteCharacter.h"
+#include "SGF/Sprites.h"
+#include "SGF/TileFlusher.h"
+#include "SGF/TileWorkers.h"
+#include "SGF/TimerWheel.h"
+
+#ifndef SGF_BENCH_COUNT_HEAP
+#define SGF_BENCH_COUNT_HEAP 0
+#endif
+
+#ifndef SGF_BENCH_MIN_US
+#define SGF_BENCH_MIN_US 200000u
+#endif
+
+static uint32_t gHeapBytes = 0;
+
+#if SGF_BENCH_COUNT_HEAP
+void* operator new(size_t n) {
+  gHeapBytes += (uint32_t)n;
+  return malloc(n);
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+#endif
+
+namespace {
+
+constexpr int SCREEN_W = 320;
+constexpr int SCREEN_H = 240;
+constexpr int TILE_W = 64;
+constexpr int TILE_H = 48;
+
+uint16_t regionBuf[TILE_W * TILE_H];
+volatile uint32_t sink = 0;
+
+struct Rng {
+  uint32_t state;
+
+  explicit Rng(uint32_t seed) : state(seed ? seed : 1u) {}
+
+  uint32_t next() {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+  }
+
+  int range(int lo, int hi) {
+    return lo + (int)(next() % (uint32_t)(hi - lo + 1));
+  }
+};
+
+class NullRenderTarget : public IRenderTarget {
+public:
+  int width() const override { return SCREEN_W; }
+  int height() const override { return SCREEN_H; }
+  void blit565(int x0, int y0, int w, int h, const uint16_t* pix) override {
+    (void)x0;
+    (void)y0;
+    pixels += (uint32_t)(w * h);
+    sink += pix[0];
+  }
+  void blit565Scaled2x(int x0, int y0, int w, int h, const uint16_t* pix) override {
+    (void)x0;
+    (void)y0;
+    pixels += (uint32_t)(4 * w * h);
+    sink += pix[0];
+  }
+
+  uint32_t pixels = 0;
+};
+
+// Serial.print has no 64-bit overload on every core.
+void printU64(uint64_t v) {
+  if (v >= 1000000000u) {
+    printU64(v / 1000000000u);
+    uint32_t low = (uint32_t)(v % 1000000000u);
+    for (uint32_t d = 100000000u; d > 1 && low < d; d /= 10) Serial.print('0');
+    Serial.print(low);
+  } else {
+    Serial.print((uint32_t)v);
+  }
+}
+
+// Runs op() until SGF_BENCH_MIN_US elapsed; op() returns pixels produced.
+template <typename Op>
+void runBench(const char* name, Op op) {
+  op();  // warm-up
+
+  const uint32_t heapBefore = gHeapBytes;
+  uint32_t ops = 0;
+  uint64_t pixels = 0;
+  uint32_t t0 = micros();
+  uint32_t elapsed = 0;
+  do {
+    pixels += op();
+    ops++;
+    elapsed = micros() - t0;
+  } while (elapsed < SGF_BENCH_MIN_US);
+
+  uint64_t nsPerOp = ((uint64_t)elapsed * 1000u) / ops;
+  uint64_t pixelsPerS = elapsed ? (pixels * 1000000u) / elapsed : 0;
+
+  Serial.print(name);
+  Serial.print(',');
+  Serial.print(ops);
+  Serial.print(',');
+  Serial.print((uint32_t)nsPerOp);
+  Serial.print(',');
+  printU64(pixelsPerS);
+  Serial.print(',');
+#if SGF_BENCH_COUNT_HEAP
+  Serial.println((gHeapBytes - heapBefore) / ops);
+#else
+  (void)heapBefore;
+  Serial.println('-');
+#endif
+}
+
+void fillBackground(int x0, int y0, int w, int h, uint16_t* buf) {
+  for (int yy = 0; yy < h; ++yy) {
+    uint16_t c = Color565::rgb(0, (uint8_t)((y0 + yy) & 0x3F), 32);
+    uint16_t* row = buf + yy * w;
+    for (int xx = 0; xx < w; ++xx) row[xx] = c ^ (uint16_t)((x0 + xx) & 7);
+  }
+}
+
+uint32_t dirtyArea(DirtyRects& dirty) {
+  dirty.clip(SCREEN_W, SCREEN_H);
+  dirty.mergeAll();
+  uint32_t area = 0;
+  for (int i = 0; i < dirty.count(); ++i) {
+    area += (uint32_t)((dirty[i].x1 - dirty[i].x0 + 1) * (dirty[i].y1 - dirty[i].y0 + 1));
+  }
+  return area;
+}
+
+// --- DirtyRects -------------------------------------------------------------
+
+void benchDirtyRects(const char* name, bool clustered) {
+  runBench(name, [clustered]() -> uint32_t {
+    Rng rng(0xD1B7u);
+    DirtyRects dirty;
+    int cx[3] = {40, 160, 280};
+    int cy[3] = {40, 200, 120};
+    for (int i = 0; i < 24; ++i) {
+      int x = 0;
+      int y = 0;
+      if (clustered) {
+        int c = i % 3;
+        x = cx[c] + rng.range(-24, 24);
+        y = cy[c] + rng.range(-24, 24);
+      } else {
+        x = rng.range(0, SCREEN_W - 1);
+        y = rng.range(0, SCREEN_H - 1);
+      }
+      dirty.add(x, y, x + rng.range(4, 20), y + rng.range(4, 20));
+    }
+    dirty.clip(SCREEN_W, SCREEN_H);
+    dirty.mergeAll();
+    sink += (uint32_t)dirty.count();
+    return 0;
+  });
+}
+
+// --- SpriteLayer ------------------------------------------------------------
+
+uint16_t spritePixels[16 * 16];
+
+void setupSprites(SpriteLayer& layer, int count, SpriteLayer::Scale scale) {
+  Rng rng(0x5915u);
+  layer.clearAll();
+  for (int i = 0; i < count && i < SpriteLayer::kMaxSprites; ++i) {
+    SpriteLayer::Sprite& s = layer.sprite(i);
+    s.active = true;
+    s.w = 16;
+    s.h = 16;
+    s.pixels565 = spritePixels;
+    s.transparent = 0;
+    s.scale = scale;
+    // Keep every sprite inside the benchmarked tile.
+    s.setPosition(rng.range(0, TILE_W - 16), rng.range(0, TILE_H - 16));
+  }
+}
+
+void benchSprites(const char* name, int count, SpriteLayer::Scale scale) {
+  static SpriteLayer layer;
+  setupSprites(layer, count, scale);
+  runBench(name, []() -> uint32_t {
+    layer.renderRegion(0, 0, TILE_W, TILE_H, regionBuf);
+    sink += regionBuf[0];
+    return TILE_W * TILE_H;
+  });
+}
+
+// 32x32 sprite over a 32x32 tile, one scenario per blend mode.
+void benchBlend() {
+  static uint16_t pixels32[32 * 32];
+  static uint8_t mask1[4 * 32];
+  static uint8_t mask4[16 * 32];
+  static SpriteLayer layer;
+  for (int i = 0; i < 32 * 32; ++i) pixels32[i] = (uint16_t)(0x39E7u + i * 97u) | 1u;
+  for (int i = 0; i < 4 * 32; ++i) mask1[i] = (uint8_t)(0xA5u ^ i);
+  for (int i = 0; i < 16 * 32; ++i) mask4[i] = (uint8_t)(i * 37u);
+
+  struct Mode {
+    const char* name;
+    SpriteLayer::Blend blend;
+  };
+  static const Mode kModes[] = {
+    {"blend_32x32_key", SpriteLayer::Blend::Key},
+    {"blend_32x32_alpha", SpriteLayer::Blend::Alpha},
+    {"blend_32x32_mask1", SpriteLayer::Blend::Mask1},
+    {"blend_32x32_mask4", SpriteLayer::Blend::Mask4},
+    {"blend_32x32_additive", SpriteLayer::Blend::Additive},
+    {"blend_32x32_multiply", SpriteLayer::Blend::Multiply},
+  };
+
+  layer.clearAll();
+  SpriteLayer::Sprite& s = layer.sprite(0);
+  s.active = true;
+  s.w = 32;
+  s.h = 32;
+  s.pixels565 = pixels32;
+  s.transparent = 0;
+  s.alpha = 12;
+  for (const Mode& m : kModes) {
+    s.blend = m.blend;
+    s.alphaMask = (m.blend == SpriteLayer::Blend::Mask1) ? mask1 : mask4;
+    runBench(m.name, []() -> uint32_t {
+      fillBackground(0, 0, 32, 32, regionBuf);
+      layer.renderRegion(0, 0, 32, 32, regionBuf);
+      return 32 * 32;
+    });
+  }
+}
+
+// 32x32 keyed disc: per-pixel key test vs the opaque-span table that
+// tools/sgfasset emits (built here at runtime in the same layout).
+void benchSpans() {
+  static uint16_t disc[32 * 32];
+  static uint16_t spans[33 + 2 * 32];
+  static SpriteLayer layer;
+  int n = 33;
+  for (int y = 0; y < 32; ++y) {
+    spans[y] = (uint16_t)n;
+    int first = 32;
+    int last = -1;
+    for (int x = 0; x < 32; ++x) {
+      const int dx = 2 * x - 31;
+      const int dy = 2 * y - 31;
+      const bool inside = dx * dx + dy * dy <= 31 * 31;
+      disc[y * 32 + x] = inside ? (uint16_t)(0x39E7u + x * 97u + y) | 1u : 0;
+      if (inside) {
+        if (x < first) first = x;
+        last = x;
+      }
+    }
+    // Convex: one run per row.
+    if (last >= first) {
+      spans[n++] = (uint16_t)first;
+      spans[n++] = (uint16_t)(last - first + 1);
+    }
+  }
+  spans[32] = (uint16_t)n;
+
+  layer.clearAll();
+  SpriteLayer::Sprite& s = layer.sprite(0);
+  s.active = true;
+  s.w = 32;
+  s.h = 32;
+  s.pixels565 = disc;
+  s.transparent = 0;
+  runBench("sprite_32_disc_key", []() -> uint32_t {
+    fillBackground(0, 0, 32, 32, regionBuf);
+    layer.renderRegion(0, 0, 32, 32, regionBuf);
+    return 32 * 32;
+  });
+  s.opaqueSpans = spans;
+  runBench("sprite_32_disc_spans", []() -> uint32_t {
+    fillBackground(0, 0, 32, 32, regionBuf);
+    layer.renderRegion(0, 0, 32, 32, regionBuf);
+    return 32 * 32;
+  });
+}
+
+// --- Font5x7 ----------------------------------------------------------------
+
+void fontFillRect(int x, int y, int w, int h, uint16_t color565) {
+  for (int yy = y; yy < y + h; ++yy) {
+    if (yy < 0 || yy >= TILE_H) continue;
+    for (int xx = x; xx < x + w; ++xx) {
+      if (xx < 0 || xx >= TILE_W) continue;
+      regionBuf[yy * TILE_W + xx] = color565;
+    }
+  }
+}
+
+void benchFont() {
+  static const char* kText = "SCORE 0123";
+  runBench("font_draw_text_s1", []() -> uint32_t {
+    Font5x7::drawText(0, 0, kText, 1, 0xFFFF, fontFillRect);
+    return (uint32_t)(Font5x7::textWidth(kText, 1) * 7);
+  });
+  runBench("font_text_pixel_region_s2", []() -> uint32_t {
+    int w = Font5x7::textWidth(kText, 2);
+    if (w > TILE_W) w = TILE_W;
+    for (int yy = 0; yy < 14; ++yy) {
+      for (int xx = 0; xx < w; ++xx) {
+        if (Font5x7::textPixel(kText, 2, xx, yy)) regionBuf[yy * TILE_W + xx] = 0xFFFF;
+      }
+    }
+    return (uint32_t)(w * 14);
+  });
+}
+
+// --- ShapeLayer -------------------------------------------------------------
+
+void benchShapes() {
+  // 16 filled circles of radius 12..28 over the screen, rendered tile by tile:
+  // per-pixel inside test across each tile versus clipped span filling.
+  static int cx[16], cy[16], rad[16];
+  Rng rng(0x5A9Eu);
+  for (int i = 0; i < 16; ++i) {
+    cx[i] = rng.range(0, SCREEN_W - 1);
+    cy[i] = rng.range(0, SCREEN_H - 1);
+    rad[i] = rng.range(12, 28);
+  }
+
+  runBench("circles_16_pixel_test_screen", []() -> uint32_t {
+    for (int ty = 0; ty < SCREEN_H; ty += TILE_H) {
+      for (int tx = 0; tx < SCREEN_W; tx += TILE_W) {
+        for (int i = 0; i < 16; ++i) {
+          const int r2 = rad[i] * rad[i] + rad[i];
+          for (int yy = 0; yy < TILE_H; ++yy) {
+            const int dy = ty + yy - cy[i];
+            for (int xx = 0; xx < TILE_W; ++xx) {
+              const int dx = tx + xx - cx[i];
+              if (dx * dx + dy * dy <= r2) regionBuf[yy * TILE_W + xx] = 0xF800;
+            }
+          }
+        }
+      }
+    }
+    return SCREEN_W * SCREEN_H;
+  });
+
+  static ShapeLayer shapes;
+  shapes.clear();
+  for (int i = 0; i < 16; ++i) shapes.setCircle(i, cx[i], cy[i], rad[i], true, 0xF800);
+
+  runBench("circles_16_spans_screen", []() -> uint32_t {
+    for (int ty = 0; ty < SCREEN_H; ty += TILE_H) {
+      for (int tx = 0; tx < SCREEN_W; tx += TILE_W) shapes.renderRegion(tx, ty, TILE_W, TILE_H, regionBuf);
+    }
+    return SCREEN_W * SCREEN_H;
+  });
+
+  // Mixed vector HUD: lines, outlines, a rounded panel and a polygon.
+  static const int16_t arrow[] = {150, 100, 190, 120, 150, 140, 160, 120};
+  shapes.clear();
+  for (int i = 0; i < 8; ++i) {
+    shapes.setLine(i, rng.range(0, SCREEN_W - 1), rng.range(0, SCREEN_H - 1), rng.range(0, SCREEN_W - 1),
+                   rng.range(0, SCREEN_H - 1), 0xFFFF);
+  }
+  shapes.setCircle(8, 60, 60, 40, false, 0x07E0);
+  shapes.setCircle(9, 260, 180, 30, false, 0x07E0);
+  shapes.setRoundRect(10, 20, 180, 120, 48, 8, true, Color565::rgb(40, 40, 80));
+  shapes.setRoundRect(11, 20, 180, 120, 48, 8, false, 0xFFFF);
+  shapes.setPolygon(12, arrow, 4, 0xFFE0);
+
+  runBench("shapes_13_mixed_screen", []() -> uint32_t {
+    for (int ty = 0; ty < SCREEN_H; ty += TILE_H) {
+      for (int tx = 0; tx < SCREEN_W; tx += TILE_W) shapes.renderRegion(tx, ty, TILE_W, TILE_H, regionBuf);
+    }
+    return SCREEN_W * SCREEN_H;
+  });
+}
+
+// --- RectFlashAnim ----------------------------------------------------------
+
+void benchFlash() {
+  static RectFlashAnimSlot slots[8];
+  static RectFlashAnim flash(slots, 8, 0xFFFF, Color565::rgb(255, 240, 200));
+  static DirtyRects dirty;
+  Rng rng(0xF1A5u);
+  flash.clear();
+  for (int i = 0; i < 8; ++i) {
+    int x = rng.range(0, TILE_W - 16);
+    int y = rng.range(0, TILE_H - 16);
+    flash.spawn(x, y, x + 15, y + 15, 400000u, Color565::rgb(200, 0, 0), Color565::rgb(255, 80, 80));
+  }
+  flash.advance(100000u, dirty);
+
+  runBench("flash_color_at_region", []() -> uint32_t {
+    for (int yy = 0; yy < TILE_H; ++yy) {
+      for (int xx = 0; xx < TILE_W; ++xx) {
+        uint16_t c = flash.colorAt(xx, yy);
+        if (c) regionBuf[yy * TILE_W + xx] = c;
+      }
+    }
+    return TILE_W * TILE_H;
+  });
+
+  // 32 simultaneous flashes over the whole screen, rendered tile by tile.
+  static RectFlashAnimSlot slots32[32];
+  static RectFlashAnim flash32(slots32, 32, 0xFFFF, Color565::rgb(255, 240, 200));
+  flash32.clear();
+  for (int i = 0; i < 32; ++i) {
+    int x = rng.range(0, SCREEN_W - 40);
+    int y = rng.range(0, SCREEN_H - 30);
+    flash32.spawn(x, y, x + 39, y + 29, (uint32_t)rng.range(300000, 900000), Color565::rgb(200, 0, 0),
+                  Color565::rgb(255, 80, 80));
+  }
+  flash32.advance(100000u, dirty);
+
+  runBench("flash_32_color_at_screen", []() -> uint32_t {
+    for (int ty = 0; ty < SCREEN_H; ty += TILE_H) {
+      for (int tx = 0; tx < SCREEN_W; tx += TILE_W) {
+        for (int yy = 0; yy < TILE_H; ++yy) {
+          for (int xx = 0; xx < TILE_W; ++xx) {
+            uint16_t c = flash32.colorAt(tx + xx, ty + yy);
+            if (c) regionBuf[yy * TILE_W + xx] = c;
+          }
+        }
+      }
+    }
+    return SCREEN_W * SCREEN_H;
+  });
+
+  runBench("flash_32_render_region_screen", []() -> uint32_t {
+    for (int ty = 0; ty < SCREEN_H; ty += TILE_H) {
+      for (int tx = 0; tx < SCREEN_W; tx += TILE_W) flash32.renderRegion(tx, ty, TILE_W, TILE_H, regionBuf);
+    }
+    return SCREEN_W * SCREEN_H;
+  });
+
+  // Dirty area per 60 Hz frame (pixels column): markDirty() every frame
+  // versus advance() reporting phase changes and expiry only.
+  runBench("flash_32_dirty_mark_every_frame", []() -> uint32_t {
+    dirty.clear();
+    flash32.markDirty(dirty);
+    return dirtyArea(dirty);
+  });
+
+  runBench("flash_32_dirty_phase_changes", []() -> uint32_t {
+    static Rng respawn(0xF1A6u);
+    dirty.clear();
+    flash32.advance(16667u, dirty);
+    for (int i = 0; i < 32; ++i) {
+      if (slots32[i].active) continue;
+      int x = respawn.range(0, SCREEN_W - 40);
+      int y = respawn.range(0, SCREEN_H - 30);
+      flash32.spawn(x, y, x + 39, y + 29, 600000u, Color565::rgb(200, 0, 0), Color565::rgb(255, 80, 80), dirty);
+    }
+    return dirtyArea(dirty);
+  });
+}
+
+// --- TimerWheel -------------------------------------------------------------
+
+void benchTimers() {
+  static TimerWheel wheel(1000);
+  static uint32_t countdown[TimerWheel::kMaxTimers];
+  static uint32_t period[TimerWheel::kMaxTimers];
+  static uint32_t clockUs = 0;
+
+  Rng rng(0x7137u);
+  wheel.clear();
+  wheel.resync(0);
+  for (int i = 0; i < TimerWheel::kMaxTimers; ++i) {
+    period[i] = (uint32_t)rng.range(20000, 2000000);
+    countdown[i] = period[i];
+    wheel.schedule(period[i], [](void*, uint32_t arg) { sink += arg; }, nullptr, (uint32_t)i, period[i]);
+  }
+
+  // One 60 Hz frame with 64 periodic timers: polled countdowns versus the wheel.
+  runBench("timers_64_polled_frame", []() -> uint32_t {
+    for (int i = 0; i < TimerWheel::kMaxTimers; ++i) {
+      if (countdown[i] > 16667u) {
+        countdown[i] -= 16667u;
+        continue;
+      }
+      countdown[i] += period[i] - 16667u;
+      sink += (uint32_t)i;
+    }
+    return 0;
+  });
+
+  runBench("timers_64_wheel_frame", []() -> uint32_t {
+    clockUs += 16667u;
+    wheel.advance(clockUs);
+    return 0;
+  });
+}
+
+// --- Collision --------------------------------------------------------------
+
+void benchCollision() {
+  static int circles[64][3];
+  static int rects[64][4];
+  Rng rng(0xC011u);
+  for (int i = 0; i < 64; ++i) {
+    circles[i][0] = rng.range(0, SCREEN_W - 1);
+    circles[i][1] = rng.range(0, SCREEN_H - 1);
+    circles[i][2] = rng.range(2, 8);
+    rects[i][0] = rng.range(0, SCREEN_W - 1);
+    rects[i][1] = rng.range(0, SCREEN_H - 1);
+    rects[i][2] = rects[i][0] + rng.range(4, 32);
+    rects[i][3] = rects[i][1] + rng.range(4, 32);
+  }
+
+  runBench("collision_circle_rect_64x64", []() -> uint32_t {
+    uint32_t hits = 0;
+    for (int i = 0; i < 64; ++i) {
+      for (int j = 0; j < 64; ++j) {
+        hits += circleRectHit(circles[i][0], circles[i][1], circles[i][2],
+                              rects[j][0], rects[j][1], rects[j][2], rects[j][3]);
+      }
+    }
+    sink += hits;
+    return 0;
+  });
+  runBench("collision_aabb_64x64", []() -> uint32_t {
+    uint32_t hits = 0;
+    for (int i = 0; i < 64; ++i) {
+      for (int j = 0; j < 64; ++j) {
+        hits += aabbHit(rects[i][0], rects[i][1], rects[i][2], rects[i][3],
+                        rects[j][0], rects[j][1], rects[j][2], rects[j][3]);
+      }
+    }
+    sink += hits;
+    return 0;
+  });
+}
+
+// 64 movers (8x12 px) take one step through a 40x30 level of 8x8 tiles:
+// TileGrid::sweep over the solid-tile bitmap vs every solid tile as a wall
+// rect tested with aabbHit, one axis at a time.
+void benchTileCollision() {
+  constexpr int kCols = 40;
+  constexpr int kRows = 30;
+  constexpr int kTile = 8;
+  constexpr int kMovers = 64;
+  static uint8_t solid[((kCols + 7) / 8) * kRows];
+  static int16_t walls[kCols * kRows][4];
+  static int wallCount = 0;
+  static int32_t startX[kMovers], startY[kMovers], velX[kMovers], velY[kMovers];
+  static TileGrid grid(solid, kCols, kRows, kTile, kTile);
+
+  Rng rng(0x711Eu);
+  for (int r = 0; r < kRows; ++r) {
+    for (int c = 0; c < kCols; ++c) {
+      const bool border = r == 0 || c == 0 || r == kRows - 1 || c == kCols - 1;
+      if (!border && rng.range(0, 9) != 0) continue;
+      solid[r * ((kCols + 7) / 8) + c / 8] |= (uint8_t)(0x80u >> (c & 7));
+      walls[wallCount][0] = (int16_t)(c * kTile);
+      walls[wallCount][1] = (int16_t)(r * kTile);
+      walls[wallCount][2] = (int16_t)(c * kTile + kTile - 1);
+      walls[wallCount][3] = (int16_t)(r * kTile + kTile - 1);
+      wallCount++;
+    }
+  }
+  for (int i = 0; i < kMovers; ++i) {
+    do {
+      startX[i] = rng.range(kTile, (kCols - 2) * kTile);
+      startY[i] = rng.range(kTile, (kRows - 3) * kTile);
+    } while (grid.boxHit(startX[i], startY[i], startX[i] + 7, startY[i] + 11));
+    velX[i] = rng.range(-3, 3);
+    velY[i] = rng.range(-3, 3);
+  }
+
+  runBench("tilegrid_sweep_64_movers", []() -> uint32_t {
+    constexpr int32_t kOne = 1 << TileGrid::kFracBits;
+    uint32_t hits = 0;
+    for (int i = 0; i < kMovers; ++i) {
+      const TileGrid::Sweep s =
+        grid.sweep(startX[i] * kOne, startY[i] * kOne, 8, 12, velX[i] * kOne, velY[i] * kOne);
+      hits += s.hit + (uint32_t)((s.x >> 8) ^ (s.y >> 8));
+    }
+    sink += hits;
+    return 0;
+  });
+  runBench("tilegrid_brute_rects_64_movers", []() -> uint32_t {
+    uint32_t hits = 0;
+    for (int i = 0; i < kMovers; ++i) {
+      int x = startX[i] + velX[i];
+      int y = startY[i];
+      for (int j = 0; j < wallCount; ++j) {
+        if (!aabbHit(x, y, x + 7, y + 11, walls[j][0], walls[j][1], walls[j][2], walls[j][3])) continue;
+        x = velX[i] > 0 ? walls[j][0] - 8 : walls[j][2] + 1;
+        hits++;
+      }
+      y += velY[i];
+      for (int j = 0; j < wallCount; ++j) {
+        if (!aabbHit(x, y, x + 7, y + 11, walls[j][0], walls[j][1], walls[j][2], walls[j][3])) continue;
+        y = velY[i] > 0 ? walls[j][1] - 12 : walls[j][3] + 1;
+        hits++;
+      }
+      hits += (uint32_t)(x ^ y);
+    }
+    sink += hits;
+    return 0;
+  });
+}
+
+// --- TileFlusher ------------------------------------------------------------
+
+void benchFlusher() {
+  static SpriteLayer layer;
+  static DirtyRects dirty;
+  static NullRenderTarget target;
+  static TileFlusher flusher(dirty, TILE_W, TILE_H);
+
+  layer.clearAll();
+  for (int i = 0; i < SpriteLayer::kMaxSprites; ++i) {
+    SpriteLayer::Sprite& s = layer.sprite(i);
+    s.active = true;
+    s.w = 16;
+    s.h = 16;
+    s.pixels565 = spritePixels;
+  }
+
+  // Each moving-sprite run starts from the same positions and random walk.
+  static Rng move(1u);
+  auto placeSprites = []() {
+    Rng rng(0x7117u);
+    for (int i = 0; i < SpriteLayer::kMaxSprites; ++i) {
+      layer.sprite(i).setPosition(rng.range(0, SCREEN_W - 16), rng.range(0, SCREEN_H - 16));
+    }
+    move = Rng(0x30E5u);
+  };
+  placeSprites();
+
+  auto render = [](int x0, int y0, int w, int h, uint16_t* buf) {
+    fillBackground(x0, y0, w, h, buf);
+    layer.renderRegion(x0, y0, w, h, buf);
+  };
+
+  runBench("flusher_full_screen", [&render]() -> uint32_t {
+    target.pixels = 0;
+    dirty.invalidate(target);
+    flusher.flush(target, regionBuf, render);
+    return target.pixels;
+  });
+
+  auto moveSprites = []() {
+    for (int i = 0; i < SpriteLayer::kMaxSprites; ++i) {
+      SpriteLayer::Sprite& s = layer.sprite(i);
+      int x0 = 0;
+      int y0 = 0;
+      int x1 = 0;
+      int y1 = 0;
+      SpriteLayer::spriteBounds(s, &x0, &y0, &x1, &y1);
+      dirty.add(x0, y0, x1, y1);
+      // Clamped, so the walk stays on screen however many ops a run does.
+      s.translate(move.range(-2, 2), move.range(-2, 2));
+      s.setPosition(s.x < 0 ? 0 : (s.x > SCREEN_W - 16 ? SCREEN_W - 16 : s.x),
+                    s.y < 0 ? 0 : (s.y > SCREEN_H - 16 ? SCREEN_H - 16 : s.y));
+      SpriteLayer::spriteBounds(s, &x0, &y0, &x1, &y1);
+      dirty.add(x0, y0, x1, y1);
+    }
+  };
+
+  runBench("flusher_sprites_moving", [&render, &moveSprites]() -> uint32_t {
+    target.pixels = 0;
+    moveSprites();
+    flusher.flush(target, regionBuf, render);
+    return target.pixels;
+  });
+
+  // Static screen: after the first pass every tile hashes the same.
+  static uint32_t tileHashes[(SCREEN_W / TILE_W) * (SCREEN_H / TILE_H)];
+  flusher.enableTileHashing(tileHashes, (int)(sizeof(tileHashes) / sizeof(tileHashes[0])));
+  placeSprites();
+  runBench("flusher_full_screen_hashed", [&render]() -> uint32_t {
+    target.pixels = 0;
+    dirty.invalidate(target);
+    flusher.flush(target, regionBuf, render);
+    return target.pixels;
+  });
+  // Partial dirty areas with hashing: whole tiles are rendered and hashed,
+  // only the dirty parts of a changed tile are sent. pixels_per_s here is the
+  // bus traffic, compare it with flusher_sprites_moving.
+  runBench("flusher_sprites_moving_hashed", [&render, &moveSprites]() -> uint32_t {
+    target.pixels = 0;
+    moveSprites();
+    flusher.flush(target, regionBuf, render);
+    return target.pixels;
+  });
+  flusher.disableTileHashing();
+
+  // Worker scaling; the render callback only reads shared state.
+  static uint16_t workerArena[TileWorkers::kMaxWorkers * TileWorkers::kSlotsPerWorker * TILE_W * TILE_H];
+  static const char* kWorkerNames[TileWorkers::kMaxWorkers] = {
+    "flusher_full_screen_workers_1",
+    "flusher_full_screen_workers_2",
+    "flusher_full_screen_workers_3",
+    "flusher_full_screen_workers_4",
+  };
+  for (int n = 1; n <= TileWorkers::kMaxWorkers; ++n) {
+    TileWorkers workers(workerArena, TILE_W * TILE_H, n);
+    if (!workers.start()) continue;
+    runBench(kWorkerNames[n - 1], [&render, &workers]() -> uint32_t {
+      target.pixels = 0;
+      dirty.invalidate(target);
+      flusher.flush(target, workers, render);
+      return target.pixels;
+    });
+    workers.stop();
+  }
+}
+
+// --- Save-under background cache --------------------------------------------
+
+// Procedural starfield: a few hash rounds per pixel, standing in for an
+// expensive static background.
+void starfieldBackground(int x0, int y0, int w, int h, uint16_t* buf) {
+  for (int yy = 0; yy < h; ++yy) {
+    uint16_t* row = buf + yy * w;
+    for (int xx = 0; xx < w; ++xx) {
+      uint32_t v = (uint32_t)(x0 + xx) * 73856093u ^ (uint32_t)(y0 + yy) * 19349663u;
+      for (int k = 0; k < 4; ++k) {
+        v ^= v >> 15;
+        v *= 0x2C1B3C6Du;
+      }
+      const uint8_t b = (v & 0xFF) > 250 ? (uint8_t)(v >> 8) : (uint8_t)((y0 + yy) >> 3);
+      row[xx] = Color565::rgb(b, b, (uint8_t)(b | 0x20));
+    }
+  }
+}
+
+// 8 sprites idling around their home positions (+-2 px) over the starfield:
+// every frame repaints old and new bounds. With save-under (margin 4) the
+// starfield is rendered once per sprite and restored from the cache after.
+void benchSaveUnder() {
+  static SpriteLayer layer;
+  static DirtyRects dirty;
+  static NullRenderTarget target;
+  static TileFlusher flusher(dirty, TILE_W, TILE_H);
+  static uint16_t arena[8 * 24 * 24];
+  static int homeX[SpriteLayer::kMaxSprites];
+  static int homeY[SpriteLayer::kMaxSprites];
+
+  layer.clearAll();
+  for (int i = 0; i < SpriteLayer::kMaxSprites; ++i) {
+    SpriteLayer::Sprite& s = layer.sprite(i);
+    s.active = true;
+    s.w = 16;
+    s.h = 16;
+    s.pixels565 = spritePixels;
+    homeX[i] = 8 + (i % 4) * 80;
+    homeY[i] = 16 + (i / 4) * 120;
+    s.setPosition(homeX[i], homeY[i]);
+  }
+
+  static Rng move(1u);
+  auto step = []() {
+    for (int i = 0; i < SpriteLayer::kMaxSprites; ++i) {
+      SpriteLayer::Sprite& s = layer.sprite(i);
+      int x0 = 0;
+      int y0 = 0;
+      int x1 = 0;
+      int y1 = 0;
+      SpriteLayer::spriteBounds(s, &x0, &y0, &x1, &y1);
+      dirty.add(x0, y0, x1, y1);
+      s.setPosition(homeX[i] + move.range(-2, 2), homeY[i] + move.range(-2, 2));
+      SpriteLayer::spriteBounds(s, &x0, &y0, &x1, &y1);
+      dirty.add(x0, y0, x1, y1);
+    }
+  };
+
+  auto direct = [](int x0, int y0, int w, int h, uint16_t* buf) {
+    starfieldBackground(x0, y0, w, h, buf);
+    layer.renderRegion(x0, y0, w, h, buf);
+  };
+  move = Rng(0x5A5Au);
+  runBench("flusher_idle_starfield_direct", [&direct, &step]() -> uint32_t {
+    target.pixels = 0;
+    step();
+    flusher.flush(target, regionBuf, direct);
+    return target.pixels;
+  });
+
+  auto cached = [](int x0, int y0, int w, int h, uint16_t* buf) {
+    layer.renderBackground(x0, y0, w, h, buf);
+    layer.renderRegion(x0, y0, w, h, buf);
+  };
+  layer.setSaveUnderArena(arena, sizeof(arena) / sizeof(arena[0]), SCREEN_W, SCREEN_H, starfieldBackground);
+  for (int i = 0; i < SpriteLayer::kMaxSprites; ++i) layer.setSaveUnder(i, 4);
+  move = Rng(0x5A5Au);
+  runBench("flusher_idle_starfield_save_under", [&cached, &step]() -> uint32_t {
+    target.pixels = 0;
+    step();
+    flusher.flush(target, regionBuf, cached);
+    return target.pixels;
+  });
+  layer.setSaveUnderArena(nullptr, 0, 0, 0, nullptr);
+}
+
+// --- Low-resolution mode ----------------------------------------------------
+
+// An 8-sprite scene at 2x: composed at full resolution with
+// Scale::Double versus composed at 160x120 and doubled by the target.
+// Both push 320x240 pixels; the low-res tiles need a quarter of the buffer.
+void benchLowRes() {
+  static SpriteLayer full;
+  static SpriteLayer low;
+  static DirtyRects dirty;
+  static NullRenderTarget target;
+  static TileFlusher fullFlusher(dirty, TILE_W, TILE_H);
+  static TileFlusher lowFlusher(dirty, TILE_W / 2, TILE_H / 2);
+  static uint16_t lowBuf[(TILE_W / 2) * (TILE_H / 2)];
+
+  lowFlusher.setPixelDoubling(true);
+  Rng rng(0x10E5u);
+  for (int i = 0; i < SpriteLayer::kMaxSprites; ++i) {
+    SpriteLayer::Sprite& s = full.sprite(i);
+    s.active = true;
+    s.w = 16;
+    s.h = 16;
+    s.pixels565 = spritePixels;
+    s.scale = SpriteLayer::Scale::Double;
+    int x = rng.range(0, SCREEN_W / 2 - 16);
+    int y = rng.range(0, SCREEN_H / 2 - 16);
+    s.setPosition(2 * x, 2 * y);
+    SpriteLayer::Sprite& l = low.sprite(i);
+    l = s;
+    l.scale = SpriteLayer::Scale::Normal;
+    l.setPosition(x, y);
+  }
+
+  runBench("full_res_scale_double_screen", []() -> uint32_t {
+    target.pixels = 0;
+    dirty.add(0, 0, SCREEN_W - 1, SCREEN_H - 1);
+    fullFlusher.flush(target, regionBuf, [](int x0, int y0, int w, int h, uint16_t* buf) {
+      fillBackground(x0, y0, w, h, buf);
+      full.renderRegion(x0, y0, w, h, buf);
+    });
+    return target.pixels;
+  });
+
+  runBench("low_res_doubled_screen", []() -> uint32_t {
+    target.pixels = 0;
+    dirty.add(0, 0, SCREEN_W / 2 - 1, SCREEN_H / 2 - 1);
+    lowFlusher.flush(target, lowBuf, [](int x0, int y0, int w, int h, uint16_t* buf) {
+      fillBackground(x0, y0, w, h, buf);
+      low.renderRegion(x0, y0, w, h, buf);
+    });
+    return target.pixels;
+  });
+}
+
+// --- ParticleSystem ---------------------------------------------------------
+
+void benchParticles() {
+  static ParticleSystem<512> particles;
+  static DirtyRects dirty;
+
+  // One frame: respawn to 512, update, emit dirty rects, render every tile.
+  runBench("particles_512_frame", []() -> uint32_t {
+    static Rng rng(0x9A27u);
+    particles.setGravity(0, 200);
+    while (particles.count() < 512) {
+      int burst = (int)(rng.next() & 3u);
+      particles.spawn(40 + burst * 80, 60, rng.range(-120, 120), rng.range(-160, 40),
+                      (uint32_t)rng.range(200000, 900000), (uint16_t)rng.next());
+    }
+    particles.update(16667u);
+    dirty.clear();
+    particles.emitDirty(dirty);
+    for (int y = 0; y < SCREEN_H; y += TILE_H) {
+      for (int x = 0; x < SCREEN_W; x += TILE_W) particles.renderRegion(x, y, TILE_W, TILE_H, regionBuf);
+    }
+    sink += (uint32_t)dirty.count();
+    return SCREEN_W * SCREEN_H;
+  });
+}
+
+// --- Entities ---------------------------------------------------------------
+
+class BenchMover : public SpriteCharacter {
+public:
+  int vx = 0;
+  int vy = 0;
+
+protected:
+  void configureBoundSprite(SpriteLayer::Sprite& s) override {
+    s.w = 16;
+    s.h = 16;
+    s.pixels565 = spritePixels;
+  }
+};
+
+void benchEntities() {
+  constexpr int kCount = 256;
+  static SpriteLayer layer;
+  static DirtyRects dirty;
+  static BenchMover* movers[kCount];
+  static EntityStorage<kCount> store;
+
+  Rng rng(0xE7E7u);
+  for (int i = 0; i < kCount; ++i) {
+    int x = rng.range(0, SCREEN_W - 16);
+    int y = rng.range(0, SCREEN_H - 16);
+    int vx = rng.range(-3, 3);
+    int vy = rng.range(-3, 3);
+
+    movers[i] = new BenchMover();
+    movers[i]->setPosition(x, y);
+    movers[i]->vx = vx;
+    movers[i]->vy = vy;
+    bool bound = i < SpriteLayer::kMaxSprites;
+    if (bound) movers[i]->bindSprite(layer.sprite(i));
+
+    EntityStore::Id id = store.create(x, y, bound ? i : -1);
+    store.setVelocity(id, vx * 60, vy * 60);
+  }
+
+  // One frame: move every entity, keep the sprite slots of the first
+  // kMaxSprites in sync and collect dirty rects for their old and new bounds.
+  runBench("entities_256_virtual", []() -> uint32_t {
+    dirty.clear();
+    for (int i = 0; i < kCount; ++i) {
+      BenchMover* m = movers[i];
+      int x0, y0, x1, y1;
+      bool bound = i < SpriteLayer::kMaxSprites;
+      if (bound) {
+        SpriteLayer::spriteBoundsPadded(layer.sprite(i), 0, &x0, &y0, &x1, &y1);
+        dirty.add(x0, y0, x1, y1);
+      }
+      Character::Position pos = m->getPosition();
+      m->setPosition(pos.x + m->vx, pos.y + m->vy);
+      if (bound) {
+        SpriteLayer::spriteBoundsPadded(layer.sprite(i), 0, &x0, &y0, &x1, &y1);
+        dirty.add(x0, y0, x1, y1);
+      }
+    }
+    sink += (uint32_t)dirty.count();
+    return 0;
+  });
+
+  runBench("entities_256_store", []() -> uint32_t {
+    dirty.clear();
+    store.integrate(16667u);
+    store.syncSprites(layer, &dirty);
+    sink += (uint32_t)dirty.count();
+    return 0;
+  });
+}
+
+// --- AnimatedSprite ---------------------------------------------------------
+
+void benchAnimation() {
+  constexpr int kCount = 256;
+  static SpriteLayer::Sprite sprites[kCount];
+  static AnimatedSprite anims[kCount];
+  static DirtyRects dirty;
+  // The 256 test sprite pixels read as a sheet of four 8x8 frames.
+  static const SpriteSheet sheet{spritePixels, nullptr, 8, 8, 4};
+  static const AnimationClip walk{&sheet, nullptr, nullptr, 120, 0, AnimationClip::Mode::Loop};
+
+  Rng rng(0xA11Au);
+  for (int i = 0; i < kCount; ++i) {
+    sprites[i].active = true;
+    sprites[i].setPosition(rng.range(0, SCREEN_W - 8), rng.range(0, SCREEN_H - 8));
+    anims[i].bind(sprites[i]);
+    anims[i].play(walk, dirty);
+    anims[i].advance((uint32_t)rng.range(0, 119999), dirty);
+  }
+
+  // One 60 Hz frame of 256 looping animations with 120 ms frames: most
+  // updates are a single compare, ~35 frame changes emit dirty rects.
+  runBench("animated_sprites_256_frame", []() -> uint32_t {
+    dirty.clear();
+    for (int i = 0; i < kCount; ++i) anims[i].advance(16667u, dirty);
+    sink += (uint32_t)dirty.count();
+    return 0;
+  });
+}
+
+// --- DisplayList ------------------------------------------------------------
+
+void benchDisplayList() {
+  static DisplayList list(SCREEN_W, SCREEN_H, 32, 32);
+  static DirtyRects dirty;
+  static NullRenderTarget target;
+  static TileFlusher flusher(dirty, 32, 32);
+  static uint16_t tileBuf[32 * 32];
+
+  runBench("display_list_40_cmds_1_moving", []() -> uint32_t {
+    static int frame = 0;
+    frame++;
+    target.pixels = 0;
+    list.begin();
+    Rng rng(0xD15Bu);
+    for (int i = 0; i < 32; ++i) {
+      list.fillRect(rng.range(0, SCREEN_W - 24), rng.range(0, SCREEN_H - 24), 24, 24, (uint16_t)rng.next());
+    }
+    for (int i = 0; i < 4; ++i) {
+      list.line(rng.range(0, SCREEN_W - 1), rng.range(0, SCREEN_H - 1),
+                rng.range(0, SCREEN_W - 1), rng.range(0, SCREEN_H - 1), 0xFFFF);
+    }
+    list.text(4, 4, "SCORE 0123", 2, 0xFFE0);
+    list.sprite(100 + (frame & 31), 120, 16, 16, spritePixels, 0);
+    list.end(dirty);
+    flusher.flush(target, tileBuf, [](int x0, int y0, int w, int h, uint16_t* buf) {
+      list.renderRegion(x0, y0, w, h, buf);
+    });
+    return target.pixels;
+  });
+}
+
+void runAll() {
+  for (int i = 0; i < 16 * 16; ++i) {
+    int x = i % 16;
+    int y = i / 16;
+    bool edge = x == 0 || y == 0 || x == 15 || y == 15;
+    spritePixels[i] = edge ? 0 : Color565::rgb((uint8_t)(x * 16), (uint8_t)(y * 16), 128);
+  }
+
+  Serial.println("# sgf-bench v1");
+  Serial.println("name,ops,ns_per_op,pixels_per_s,heap_bytes");
+
+  benchDirtyRects("dirty_add_merge_random_24", false);
+  benchDirtyRects("dirty_add_merge_clustered_24", true);
+
+  benchSprites("sprites_1_normal", 1, SpriteLayer::Scale::Normal);
+  benchSprites("sprites_8_normal", 8, SpriteLayer::Scale::Normal);
+  benchSprites("sprites_8_double_x", 8, SpriteLayer::Scale::DoubleX);
+  benchSprites("sprites_8_double", 8, SpriteLayer::Scale::Double);
+
+  benchBlend();
+  benchSpans();
+  benchFont();
+  benchShapes();
+  benchFlash();
+  benchTimers();
+  benchCollision();
+  benchTileCollision();
+  benchFlusher();
+  benchSaveUnder();
+  benchDisplayList();
+  benchLowRes();
+  benchParticles();
+  benchEntities();
+  benchAnimation();
+
+  Serial.println("# done");
+}
+
+}  // namespace
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {
+  }
+  runAll();
+}
+
+void loop() {}
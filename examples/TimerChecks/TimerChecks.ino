@@ -0,0 +1,204 @@
+// Host-checkable TimerWheel behaviour.
+//
+// Drives TimerWheel (1 ms ticks) one millisecond at a time and checks when
+// callbacks fire: periodic timers across the 64-tick slot and level
+// boundaries, timers rescheduled from their own callback, cancel() from a
+// callback in the same tick, and the timer-driven RectFlashAnim and
+// AnimatedSprite against their polled counterparts. Each check prints:
+//
+//   check,status
+
+#include <Arduino.h>
+
+#include "SGF/AnimatedSprite.h"
+#include "SGF/DirtyRects.h"
+#include "SGF/RectFlashAnim.h"
+#include "SGF/Sprites.h"
+#include "SGF/TimerWheel.h"
+
+namespace {
+
+int checks = 0;
+int failures = 0;
+
+void report(const char* check, bool ok) {
+  checks++;
+  if (!ok) failures++;
+  Serial.print(check);
+  Serial.print(',');
+  Serial.println(ok ? "ok" : "FAIL");
+}
+
+// Callback runs, each expected at the next multiple of stepMs.
+struct FireLog {
+  uint32_t stepMs = 0;
+  int count = 0;
+  bool late = false;
+};
+
+uint32_t nowMs = 0;
+
+void logFire(void* user, uint32_t arg) {
+  (void)arg;
+  FireLog* log = (FireLog*)user;
+  log->count++;
+  if (nowMs != (uint32_t)log->count * log->stepMs) log->late = true;
+}
+
+void runTo(TimerWheel& wheel, uint32_t endMs) {
+  for (nowMs = 1; nowMs <= endMs; nowMs++) wheel.advance(nowMs * 1000u);
+}
+
+// A periodic timer fires exactly at k * period, once each.
+bool periodicFires(uint32_t periodMs, uint32_t endMs) {
+  TimerWheel wheel;
+  wheel.advance(0);
+  FireLog log;
+  log.stepMs = periodMs;
+  wheel.schedule(periodMs * 1000u, logFire, &log, 0, periodMs * 1000u);
+  runTo(wheel, endMs);
+  return !log.late && log.count == (int)(endMs / periodMs);
+}
+
+struct Rescheduler {
+  TimerWheel* wheel;
+  FireLog log;
+};
+
+void rescheduleSelf(void* user, uint32_t arg) {
+  Rescheduler* r = (Rescheduler*)user;
+  logFire(&r->log, arg);
+  r->wheel->schedule(r->log.stepMs * 1000u, rescheduleSelf, r);
+}
+
+// A one-shot timer that schedules itself again from its callback.
+bool rescheduleFires(uint32_t delayMs, uint32_t endMs) {
+  TimerWheel wheel;
+  wheel.advance(0);
+  Rescheduler r{&wheel, FireLog{}};
+  r.log.stepMs = delayMs;
+  wheel.schedule(delayMs * 1000u, rescheduleSelf, &r);
+  runTo(wheel, endMs);
+  return !r.log.late && r.log.count == (int)(endMs / delayMs);
+}
+
+struct CancelPair {
+  TimerWheel* wheel;
+  TimerWheel::Handle handles[2];
+  int fired;
+};
+
+void cancelOther(void* user, uint32_t arg) {
+  CancelPair* p = (CancelPair*)user;
+  p->fired++;
+  p->wheel->cancel(p->handles[arg ^ 1u]);
+}
+
+void checkTimerWheel() {
+  static const uint32_t kPeriods[] = {1, 2, 7, 63, 64, 65, 127, 128, 129, 4095, 4096, 4097};
+  bool ok = periodicFires(64, 300);
+  report("period_64", ok);
+  ok = true;
+  for (uint32_t p : kPeriods) ok = ok && periodicFires(p, 9000);
+  report("period_sweep", ok);
+
+  report("reschedule_in_callback_64", rescheduleFires(64, 1000));
+  ok = true;
+  for (uint32_t d : kPeriods) ok = ok && rescheduleFires(d, 9000);
+  report("reschedule_in_callback_sweep", ok);
+
+  // Both due in the same tick: whichever runs first cancels the other.
+  TimerWheel wheel;
+  wheel.advance(0);
+  CancelPair pair{&wheel, {0, 0}, 0};
+  pair.handles[0] = wheel.schedule(10000, cancelOther, &pair, 0);
+  pair.handles[1] = wheel.schedule(10000, cancelOther, &pair, 1);
+  runTo(wheel, 20);
+  report("cancel_in_callback_same_tick", pair.fired == 1 && wheel.count() == 0);
+}
+
+// 256 ms flash: the timer-driven colours match the polled ones every
+// millisecond and go through all four phases.
+void checkRectFlash() {
+  static RectFlashAnimSlot polledSlots[1];
+  static RectFlashAnimSlot timedSlots[1];
+  RectFlashAnim polled(polledSlots, 1, 0xFFFF, 0xFFDE);
+  RectFlashAnim timed(timedSlots, 1, 0xFFFF, 0xFFDE);
+  TimerWheel wheel;
+  DirtyRects polledDirty;
+  DirtyRects timedDirty;
+  wheel.advance(0);
+  timed.attachTimers(&wheel, &timedDirty);
+  polled.spawn(0, 0, 7, 7, 256000u, 0x001F, 0x841F);
+  timed.spawn(0, 0, 7, 7, 256000u, 0x001F, 0x841F);
+
+  bool same = true;
+  uint16_t seen[8];
+  int seenCount = 0;
+  for (nowMs = 1; nowMs <= 300; nowMs++) {
+    polled.advance(1000u, polledDirty);
+    wheel.advance(nowMs * 1000u);
+    const uint16_t a = polled.colorAt(3, 3);
+    const uint16_t b = timed.colorAt(3, 3);
+    if (a != b) same = false;
+    if (seenCount == 0 || seen[seenCount - 1] != b) {
+      if (seenCount < 8) seen[seenCount] = b;
+      seenCount++;
+    }
+  }
+  report("rect_flash_256_matches_polled", same);
+  // white, warm white, light, base, then nothing (colorAt returns 0).
+  report("rect_flash_256_phases", seenCount == 5 && seen[0] == 0xFFFF && seen[1] == 0xFFDE && seen[2] == 0x841F &&
+                                    seen[3] == 0x001F);
+}
+
+// 64 ms frames: the timer-driven animation shows the same frame as the
+// polled one every millisecond.
+void checkAnimatedSprite() {
+  static uint16_t pixels[4 * 2 * 2];
+  static const SpriteSheet sheet{pixels, nullptr, 2, 2, 4};
+  static const AnimationClip clip{&sheet, nullptr, nullptr, 64, 0, AnimationClip::Mode::Loop};
+  SpriteLayer layer;
+  AnimatedSprite polled;
+  AnimatedSprite timed;
+  TimerWheel wheel;
+  DirtyRects dirty;
+  wheel.advance(0);
+  polled.bind(layer.sprite(0));
+  timed.bind(layer.sprite(1));
+  timed.attachTimers(&wheel, &dirty);
+  polled.play(clip, dirty);
+  timed.play(clip, dirty);
+
+  bool same = true;
+  int changes = 0;
+  int last = timed.frame();
+  for (nowMs = 1; nowMs <= 1000; nowMs++) {
+    polled.advance(1000u, dirty);
+    wheel.advance(nowMs * 1000u);
+    dirty.clear();
+    if (polled.frame() != timed.frame()) same = false;
+    if (timed.frame() != last) changes++;
+    last = timed.frame();
+  }
+  report("animated_sprite_64_matches_polled", same);
+  report("animated_sprite_64_frame_changes", changes == 1000 / 64);
+}
+
+}  // namespace
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {
+  }
+  Serial.println("check,status");
+  checkTimerWheel();
+  checkRectFlash();
+  checkAnimatedSprite();
+  Serial.print("# checks=");
+  Serial.print(checks);
+  Serial.print(" failures=");
+  Serial.println(failures);
+}
+
+void loop() {}
@@ -0,0 +1,74 @@
+#pragma once
+
+// Minimal Arduino API for building the examples on a desktop host (see
+// Makefile). Only what the library and the example sketches use.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+#define DEC 10
+#define HEX 16
+
+inline void pinMode(int, int) {}
+inline int digitalRead(int) { return HIGH; }
+inline void digitalWrite(int, int) {}
+inline void analogWrite(int, int) {}
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+template <class T>
+T min(T a, T b) {
+  return a < b ? a : b;
+}
+template <class T>
+T max(T a, T b) {
+  return a > b ? a : b;
+}
+
+// Serial goes to stdout.
+class HostSerial {
+public:
+  void begin(unsigned long) {}
+  explicit operator bool() const { return true; }
+
+  size_t print(const char* s) { return (size_t)fputs(s, stdout) >= 0 ? strlen(s) : 0; }
+  size_t print(char c) { return putchar(c) == EOF ? 0 : 1; }
+  size_t print(int v, int base = DEC) { return print((long)v, base); }
+  size_t print(unsigned v, int base = DEC) { return print((unsigned long)v, base); }
+  size_t print(long v, int base = DEC) {
+    return base == HEX ? (size_t)printf("%lx", (unsigned long)v) : (size_t)printf("%ld", v);
+  }
+  size_t print(unsigned long v, int base = DEC) {
+    return (size_t)printf(base == HEX ? "%lx" : "%lu", v);
+  }
+  size_t print(double v, int digits = 2) { return (size_t)printf("%.*f", digits, v); }
+
+  template <class T>
+  size_t println(T v) {
+    size_t n = print(v);
+    return n + println();
+  }
+  template <class T>
+  size_t println(T v, int arg) {
+    size_t n = print(v, arg);
+    return n + println();
+  }
+  size_t println() { return print('\n'); }
+
+  size_t write(uint8_t c) { return print((char)c); }
+  size_t write(const uint8_t* data, size_t len) { return fwrite(data, 1, len, stdout); }
+  void flush() { fflush(stdout); }
+};
+
+extern HostSerial Serial;
@@ -0,0 +1,40 @@
+// Runs an Arduino sketch on the host: setup() once, then loop()
+// SGF_HOST_LOOPS times (the examples do all their work in setup()).
+
+#include <Arduino.h>
+
+#include <chrono>
+#include <thread>
+
+#ifndef SGF_HOST_LOOPS
+#define SGF_HOST_LOOPS 1
+#endif
+
+HostSerial Serial;
+
+namespace {
+
+const auto kStart = std::chrono::steady_clock::now();
+
+}  // namespace
+
+uint32_t micros() {
+  return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - kStart)
+    .count();
+}
+
+uint32_t millis() { return micros() / 1000u; }
+
+void delay(uint32_t ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+
+void delayMicroseconds(uint32_t us) { std::this_thread::sleep_for(std::chrono::microseconds(us)); }
+
+void setup();
+void loop();
+
+int main() {
+  setup();
+  for (int i = 0; i < SGF_HOST_LOOPS; i++) loop();
+  fflush(stdout);
+  return 0;
+}
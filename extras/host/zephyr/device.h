@@ -0,0 +1,18 @@
+#pragma once
+
+// Host stand-in: every device lookup yields a null device that reports ready.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct device {
+  const char* name;
+};
+
+#define DT_NODELABEL(label) label
+#define DEVICE_DT_GET(node) ((const struct device*)0)
+
+static inline bool device_is_ready(const struct device* dev) {
+  (void)dev;
+  return true;
+}
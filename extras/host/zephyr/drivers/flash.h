@@ -0,0 +1,17 @@
+#pragma once
+
+// Host stand-in: there is no flash device (use FileBlockDevice or
+// MemoryBlockDevice instead).
+
+#include <stddef.h>
+#include <sys/types.h>
+
+struct device;
+
+static inline int flash_read(const struct device* dev, off_t offset, void* data, size_t len) {
+  (void)dev;
+  (void)offset;
+  (void)data;
+  (void)len;
+  return -1;
+}
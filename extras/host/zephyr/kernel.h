@@ -0,0 +1,29 @@
+#pragma once
+
+// Host stand-in: sleeps are no-ops (the examples run on fake clocks).
+
+#include <stdint.h>
+
+typedef struct {
+  int64_t us;
+} k_timeout_t;
+
+static inline k_timeout_t K_USEC(int64_t us) {
+  k_timeout_t t = {us};
+  return t;
+}
+
+static inline k_timeout_t K_MSEC(int64_t ms) {
+  k_timeout_t t = {ms * 1000};
+  return t;
+}
+
+static inline int32_t k_sleep(k_timeout_t timeout) {
+  (void)timeout;
+  return 0;
+}
+
+static inline int32_t k_usleep(int32_t us) {
+  (void)us;
+  return 0;
+}
@@ -1,17 +1,34 @@
 #pragma once
 #include "SGF/Color565.h"
 #include "SGF/FastILI9341.h"
+#include "SGF/FastST7789.h"
+#include "SGF/FastILI9488.h"
+#include "SGF/RecordingBus.h"
 #include "SGF/DirtyRects.h"
+#include "SGF/DisplayList.h"
 #include "SGF/TileFlusher.h"
+#include "SGF/OverdrawMap.h"
+#include "SGF/TileWorkers.h"
 #include "SGF/Sprites.h"
+#include "SGF/AnimatedSprite.h"
+#include "SGF/SpriteAsset.h"
+#include "SGF/BlockDevice.h"
+#include "SGF/AssetStore.h"
+#include "SGF/ParticleSystem.h"
 #include "SGF/RectFlashAnim.h"
 #include "SGF/IRenderTarget.h"
+#include "SGF/FrameCapture.h"
 #include "SGF/Vector2.h"
+#include "SGF/EntityStore.h"
 #include "SGF/Character.h"
 #include "SGF/SpriteCharacter.h"
+#include "SGF/TimerWheel.h"
 #include "SGF/Game.h"
 #include "SGF/Actions.h"
 #include "SGF/InputPin.h"
+#include "SGF/InputBank.h"
+#include "SGF/InputEvents.h"
 #include "SGF/Scene.h"
 #include "SGF/Font5x7.h"
+#include "SGF/Primitives.h"
 #include "SGF/Collision.h"
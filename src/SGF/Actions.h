@@ -10,6 +10,24 @@ public:
     pressedFlag = isPressedNow;
   }
 
+  // Event-driven use (InputEventQueue::dispatch): clear the edges once per
+  // frame, then apply every press/release in order. A tap shorter than a frame
+  // reports justPressed and justReleased together.
+  void clearEdges() {
+    justPressedFlag = false;
+    justReleasedFlag = false;
+  }
+
+  void applyEvent(bool isPressed) {
+    if (isPressed && !pressedFlag) {
+      justPressedFlag = true;
+    }
+    if (!isPressed && pressedFlag) {
+      justReleasedFlag = true;
+    }
+    pressedFlag = isPressed;
+  }
+
   void reset(bool isPressedNow = false) {
     pressedFlag = isPressedNow;
     justPressedFlag = false;
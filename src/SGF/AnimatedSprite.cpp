@@ -0,0 +1,137 @@
+#include "AnimatedSprite.h"
+
+int AnimatedSprite::stepCount() const {
+  if (!current || !current->sheet) return 0;
+  return current->length > 0 ? current->length : current->sheet->frameCount;
+}
+
+int AnimatedSprite::frameAt(int stepIdx) const {
+  int f = current->sequence ? current->sequence[stepIdx] : stepIdx;
+  return f < current->sheet->frameCount ? f : current->sheet->frameCount - 1;
+}
+
+uint32_t AnimatedSprite::durationAt(int stepIdx) const {
+  uint32_t ms = current->durationsMs ? current->durationsMs[stepIdx] : current->frameMs;
+  return (ms ? ms : 1u) * 1000u;
+}
+
+void AnimatedSprite::play(const AnimationClip& clip, DirtyRects& dirty, bool restart) {
+  if (playing && current == &clip && !restart) return;
+
+  cancelTimer();
+  current = &clip;
+  stepPos = 0;
+  dir = 1;
+  done = false;
+  playing = stepCount() > 0 && clip.sheet->pixels565;
+  if (!playing) return;
+
+  remainingUs = durationAt(0);
+  show(frameAt(0), dirty);
+  if (timers) scheduleTimer();
+}
+
+void AnimatedSprite::stop() {
+  cancelTimer();
+  playing = false;
+}
+
+bool AnimatedSprite::nextStep() {
+  const int n = stepCount();
+  if (n <= 1) {
+    if (current->mode != AnimationClip::Mode::Once) return true;
+    done = true;
+    return false;
+  }
+
+  switch (current->mode) {
+    case AnimationClip::Mode::Loop:
+      stepPos = stepPos + 1 < n ? stepPos + 1 : 0;
+      break;
+    case AnimationClip::Mode::PingPong:
+      if (stepPos + dir < 0 || stepPos + dir >= n) dir = (int8_t)-dir;
+      stepPos += dir;
+      break;
+    case AnimationClip::Mode::Once:
+      if (stepPos + 1 >= n) {
+        done = true;
+        return false;
+      }
+      stepPos++;
+      break;
+  }
+  return true;
+}
+
+void AnimatedSprite::step(uint32_t overshootUs, DirtyRects& dirty) {
+  // Dogania wszystkie kroki, które minęły; rysowana jest tylko ostatnia klatka.
+  while (true) {
+    if (!nextStep()) {
+      playing = false;
+      return;
+    }
+    const uint32_t d = durationAt(stepPos);
+    if (overshootUs < d) {
+      remainingUs = d - overshootUs;
+      break;
+    }
+    overshootUs -= d;
+  }
+  show(frameAt(stepPos), dirty);
+}
+
+void AnimatedSprite::show(int sheetFrame, DirtyRects& dirty) {
+  shownFrame = sheetFrame;
+  if (!target) return;
+
+  const SpriteSheet& sheet = *current->sheet;
+  SpriteLayer::Sprite& s = *target;
+  const uint16_t* pixels = sheet.pixels565 + sheetFrame * sheet.frameW * sheet.frameH;
+  const bool resized = s.w != sheet.frameW || s.h != sheet.frameH;
+  if (pixels == s.pixels565 && !resized) return;
+
+  int x0, y0, x1, y1;
+  if (resized && s.active) {
+    SpriteLayer::spriteBoundsPadded(s, dirtyPad, &x0, &y0, &x1, &y1);
+    dirty.add(x0, y0, x1, y1);
+  }
+
+  s.w = sheet.frameW;
+  s.h = sheet.frameH;
+  s.pixels565 = pixels;
+  s.opaqueSpans = nullptr;  // odcinki opisują jedną klatkę
+  if (sheet.alphaMask) {
+    const int rowBytes = s.blend == SpriteLayer::Blend::Mask4 ? (sheet.frameW + 1) / 2 : (sheet.frameW + 7) / 8;
+    s.alphaMask = sheet.alphaMask + sheetFrame * rowBytes * sheet.frameH;
+  }
+
+  if (s.active) {
+    SpriteLayer::spriteBoundsPadded(s, dirtyPad, &x0, &y0, &x1, &y1);
+    dirty.add(x0, y0, x1, y1);
+  }
+}
+
+void AnimatedSprite::attachTimers(TimerWheel* wheel, DirtyRects* dirty) {
+  cancelTimer();
+  timers = (wheel && dirty) ? wheel : nullptr;
+  timerDirty = timers ? dirty : nullptr;
+  if (timers && playing) scheduleTimer();
+}
+
+void AnimatedSprite::scheduleTimer() {
+  timer = timers->schedule(remainingUs, onFrameTimer, this);
+}
+
+void AnimatedSprite::cancelTimer() {
+  if (timers && timer != TimerWheel::kInvalid) timers->cancel(timer);
+  timer = TimerWheel::kInvalid;
+}
+
+void AnimatedSprite::onFrameTimer(void* user, uint32_t arg) {
+  (void)arg;
+  AnimatedSprite& self = *static_cast<AnimatedSprite*>(user);
+  self.timer = TimerWheel::kInvalid;
+  if (!self.playing) return;
+  self.step(0, *self.timerDirty);
+  if (self.playing) self.scheduleTimer();
+}
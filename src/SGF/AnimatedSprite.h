@@ -0,0 +1,99 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "DirtyRects.h"
+#include "Sprites.h"
+#include "TimerWheel.h"
+
+// Frames of one size stored back to back: frame i starts at
+// pixels565 + i * frameW * frameH. The optional alpha mask sheet is laid out the
+// same way, with the row padding of Blend::Mask1 / Blend::Mask4.
+struct SpriteSheet {
+  const uint16_t* pixels565;
+  const uint8_t* alphaMask;  // nullptr when the sprite does not use a mask
+  int frameW;
+  int frameH;
+  int frameCount;
+};
+
+struct AnimationClip {
+  enum class Mode : uint8_t {
+    Loop,
+    PingPong,
+    Once,
+  };
+
+  const SpriteSheet* sheet;
+  const uint8_t* sequence;      // sheet frame per step; nullptr = 0, 1, 2, ...
+  const uint16_t* durationsMs;  // per step; nullptr = frameMs for every step
+  uint16_t frameMs;
+  int length;                   // steps; <= 0 means sheet->frameCount
+  Mode mode;
+};
+
+// Plays an AnimationClip on a bound SpriteLayer::Sprite.
+// The sprite's pixels (and mask) are switched only when the displayed sheet
+// frame changes, and only then are its bounds added to the dirty rects, so an
+// animation between frame changes costs one compare per update.
+//
+// Either call update()/advance() every frame, or attachTimers() to let a
+// TimerWheel drive the frame changes (one timer per playing animation).
+class AnimatedSprite {
+public:
+  void bind(SpriteLayer::Sprite& sprite) { target = &sprite; }
+  void setDirtyPadding(int pad) { dirtyPad = pad; }
+
+  // Starts clip from its first step; playing the current clip again only
+  // restarts it when restart is true.
+  void play(const AnimationClip& clip, DirtyRects& dirty, bool restart = false);
+  void stop();
+
+  void update(float deltaSeconds, DirtyRects& dirty) {
+    advance(deltaSeconds > 0.0f ? (uint32_t)(deltaSeconds * 1000000.0f) : 0u, dirty);
+  }
+  void advance(uint32_t dtUs, DirtyRects& dirty) {
+    if (!playing || timers) return;
+    if (remainingUs > dtUs) {
+      remainingUs -= dtUs;
+      return;
+    }
+    step(dtUs - remainingUs, dirty);
+  }
+
+  // Timer-driven mode; update()/advance() become no-ops. Pass nullptr to
+  // return to polling.
+  void attachTimers(TimerWheel* wheel, DirtyRects* dirty);
+
+  bool isPlaying() const { return playing; }
+  bool finished() const { return done; }
+  const AnimationClip* clip() const { return current; }
+  int stepIndex() const { return stepPos; }
+  int frame() const { return shownFrame; }
+
+private:
+  static void onFrameTimer(void* user, uint32_t arg);
+
+  int stepCount() const;
+  int frameAt(int stepIdx) const;
+  uint32_t durationAt(int stepIdx) const;
+  bool nextStep();
+  void step(uint32_t overshootUs, DirtyRects& dirty);
+  void show(int sheetFrame, DirtyRects& dirty);
+  void scheduleTimer();
+  void cancelTimer();
+
+  SpriteLayer::Sprite* target = nullptr;
+  const AnimationClip* current = nullptr;
+  int dirtyPad = 0;
+  int stepPos = 0;
+  int8_t dir = 1;
+  int shownFrame = -1;
+  bool playing = false;
+  bool done = false;
+  uint32_t remainingUs = 0;
+
+  TimerWheel* timers = nullptr;
+  DirtyRects* timerDirty = nullptr;
+  TimerWheel::Handle timer = TimerWheel::kInvalid;
+};
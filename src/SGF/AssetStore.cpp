@@ -0,0 +1,279 @@
+#include "AssetStore.h"
+
+namespace {
+
+uint16_t le16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+
+uint32_t le32(const uint8_t* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+size_t maskBytes(const AssetStore::Entry& e) {
+  const size_t rows = (size_t)e.h * e.frames;
+  if (e.blend == SpriteLayer::Blend::Mask1) return (size_t)((e.w + 7) / 8) * rows;
+  if (e.blend == SpriteLayer::Blend::Mask4) return (size_t)((e.w + 1) / 2) * rows;
+  return 0;
+}
+
+size_t indexBytes(const AssetStore::Entry& e) {
+  const size_t rows = (size_t)e.h * e.frames;
+  return e.format == SpriteAsset::Format::Indexed4 ? (size_t)((e.w + 1) / 2) * rows : (size_t)e.w * rows;
+}
+
+}  // namespace
+
+AssetStore::AssetStore(IBlockDevice& device, Entry* directory, int capacity, uint8_t* arena, size_t arenaBytes,
+                       size_t slotBytes)
+  : device(device), dir(directory), capacity(directory ? capacity : 0), arena(arena), slotBytes(slotBytes) {
+  const size_t n = (arena && slotBytes) ? arenaBytes / slotBytes : 0;
+  slots = n > (size_t)kMaxSlots ? kMaxSlots : (int)n;
+  for (int i = 0; i < kMaxSlots; i++) owner[i] = -1;
+}
+
+bool AssetStore::open() {
+  evictAll();
+  assetCount = 0;
+  queueCount = 0;
+
+  uint8_t header[kHeaderBytes];
+  if (!device.read(0, header, sizeof(header))) return false;
+  if (header[0] != 'S' || header[1] != 'G' || header[2] != 'F' || header[3] != 'P') return false;
+  if (le16(header + 4) != kVersion) return false;
+  const int n = le16(header + 6);
+  const uint32_t dirOffset = le32(header + 8);
+  if (n > capacity) return false;
+
+  for (int i = 0; i < n; i++) {
+    uint8_t r[kEntryBytes];
+    if (!device.read(dirOffset + (uint32_t)i * kEntryBytes, r, sizeof(r))) return false;
+    Entry& e = dir[i];
+    e.offset = le32(r);
+    e.storedBytes = le32(r + 4);
+    e.bytes = le32(r + 8);
+    e.w = le16(r + 12);
+    e.h = le16(r + 14);
+    e.frames = le16(r + 16) ? le16(r + 16) : 1;
+    e.anchorX = (int16_t)le16(r + 18);
+    e.anchorY = (int16_t)le16(r + 20);
+    e.transparent = le16(r + 22);
+    e.paletteSize = le16(r + 24);
+    e.spanBytes = le16(r + 26);
+    e.kind = r[28] == 1 ? Kind::Blob : Kind::Sprite;
+    e.format = (SpriteAsset::Format)r[29];
+    e.blend = r[30] == 1 ? SpriteLayer::Blend::Mask1 : r[30] == 2 ? SpriteLayer::Blend::Mask4 : SpriteLayer::Blend::Key;
+    e.keyed = (r[31] & 1) != 0;
+    e.slot = -1;
+    e.pins = 0;
+    e.lastUse = 0;
+    e.usedFrame = 0;
+
+    if (e.kind == Kind::Sprite) {
+      // Rozmiary muszą się zgadzać z układem po dekodowaniu.
+      const size_t pixels = (size_t)e.w * e.h * e.frames * 2;
+      const size_t mask = maskBytes(e);
+      size_t stored = pixels + mask + e.spanBytes;
+      if (mask && e.spanBytes) return false;  // odcinki tylko dla klucza, wyrównane do 2
+      if (e.format == SpriteAsset::Format::Indexed8 || e.format == SpriteAsset::Format::Indexed4) {
+        if (e.paletteSize == 0 || e.paletteSize > 256 || e.spanBytes) return false;
+        stored = (size_t)e.paletteSize * 2 + indexBytes(e) + mask;
+      } else if (e.format != SpriteAsset::Format::Rgb565) {
+        return false;
+      }
+      if (e.bytes != pixels + mask + e.spanBytes || e.storedBytes != stored) return false;
+    } else if (e.bytes != e.storedBytes) {
+      return false;
+    }
+  }
+  assetCount = n;
+  return true;
+}
+
+void AssetStore::beginFrame() {
+  cur.frames = 1;
+  last = cur;
+  total.frames += cur.frames;
+  total.hits += cur.hits;
+  total.misses += cur.misses;
+  total.bytesRead += cur.bytesRead;
+  total.prefetchBytes += cur.prefetchBytes;
+  total.evictions += cur.evictions;
+  total.failures += cur.failures;
+  cur = Stats{};
+  frame++;
+
+  uint32_t spent = 0;
+  while (queueCount > 0 && (prefetchBudget == 0 || spent < prefetchBudget)) {
+    const AssetHandle h = queue[queueHead];
+    queueHead = (queueHead + 1) % kMaxPrefetch;
+    queueCount--;
+    if (dir[h].slot >= 0) continue;
+    const uint32_t usedBefore = dir[h].usedFrame;
+    if (!load(h)) continue;
+    // Wczytane na zapas: w kolejności LRU, ale bez ochrony bieżącej klatki.
+    dir[h].lastUse = ++tick;
+    dir[h].usedFrame = usedBefore;
+    cur.prefetchBytes += dir[h].storedBytes;
+    spent += dir[h].storedBytes;
+  }
+}
+
+const uint8_t* AssetStore::data(AssetHandle h) {
+  if (h >= assetCount) return nullptr;
+  Entry& e = dir[h];
+  if (e.slot >= 0) {
+    cur.hits++;
+  } else {
+    cur.misses++;
+    if (!load(h)) return nullptr;
+  }
+  touch(e);
+  return arena + (size_t)e.slot * slotBytes;
+}
+
+bool AssetStore::asset(AssetHandle h, SpriteAsset* out) {
+  if (!out || h >= assetCount || dir[h].kind != Kind::Sprite) return false;
+  const uint8_t* p = data(h);
+  if (!p) return false;
+  const Entry& e = dir[h];
+  const size_t pixels = (size_t)e.w * e.h * e.frames * 2;
+  const size_t mask = maskBytes(e);
+  *out = SpriteAsset{SpriteAsset::Format::Rgb565,
+                     e.w,
+                     e.h,
+                     e.frames,
+                     e.anchorX,
+                     e.anchorY,
+                     e.keyed,
+                     e.transparent,
+                     (const uint16_t*)p,
+                     nullptr,
+                     nullptr,
+                     0,
+                     e.spanBytes ? (const uint16_t*)(p + pixels + mask) : nullptr,
+                     e.blend,
+                     mask ? p + pixels : nullptr,
+                     nullptr};
+  return true;
+}
+
+bool AssetStore::pin(AssetHandle h) {
+  if (!data(h)) return false;
+  if (dir[h].pins < 0xFF) dir[h].pins++;
+  return true;
+}
+
+void AssetStore::unpin(AssetHandle h) {
+  if (h < assetCount && dir[h].pins > 0) dir[h].pins--;
+}
+
+bool AssetStore::bindSprite(AssetHandle h, SpriteLayer::Sprite& s) {
+  SpriteAsset a;
+  if (!asset(h, &a) || !a.applyTo(s)) return false;
+  if (dir[h].pins < 0xFF) dir[h].pins++;
+  return true;
+}
+
+SpriteSheet AssetStore::sheet(AssetHandle h) {
+  SpriteAsset a;
+  if (!asset(h, &a)) return SpriteSheet{nullptr, nullptr, 0, 0, 0};
+  return a.sheet();
+}
+
+bool AssetStore::prefetch(AssetHandle h) {
+  if (h >= assetCount || dir[h].slot >= 0) return true;
+  for (int i = 0; i < queueCount; i++) {
+    if (queue[(queueHead + i) % kMaxPrefetch] == h) return true;
+  }
+  if (queueCount == kMaxPrefetch) return false;
+  queue[(queueHead + queueCount) % kMaxPrefetch] = h;
+  queueCount++;
+  return true;
+}
+
+void AssetStore::evictAll() {
+  for (int i = 0; i < assetCount; i++) {
+    if (dir[i].slot >= 0 && dir[i].pins == 0) evict((AssetHandle)i);
+  }
+}
+
+bool AssetStore::load(AssetHandle h) {
+  Entry& e = dir[h];
+  const int need = e.bytes ? (int)((e.bytes + slotBytes - 1) / slotBytes) : 1;
+  if (need > slots) {
+    cur.failures++;
+    return false;
+  }
+
+  // Najtańsze okno kolejnych slotów: wolne albo z najdawniej używanymi
+  // zasobami; przypięte i użyte w tej klatce nie mogą być usunięte.
+  int best = -1;
+  uint32_t bestCost = 0xFFFFFFFFu;
+  for (int start = 0; start + need <= slots; start++) {
+    uint32_t cost = 0;
+    bool ok = true;
+    for (int s = start; s < start + need; s++) {
+      if (owner[s] < 0) continue;
+      const Entry& o = dir[owner[s]];
+      if (o.pins || o.usedFrame == frame) {
+        ok = false;
+        start = s;  // żadne okno zawierające s nie przejdzie
+        break;
+      }
+      if (o.lastUse + 1 > cost) cost = o.lastUse + 1;
+    }
+    if (ok && cost < bestCost) {
+      best = start;
+      bestCost = cost;
+      if (cost == 0) break;
+    }
+  }
+  if (best < 0) {
+    cur.failures++;
+    return false;
+  }
+
+  for (int s = best; s < best + need; s++) {
+    if (owner[s] >= 0) {
+      evict((AssetHandle)owner[s]);
+      cur.evictions++;
+    }
+  }
+  uint8_t* dst = arena + (size_t)best * slotBytes;
+  if (!readInto(e, dst)) {
+    cur.failures++;
+    return false;
+  }
+  for (int s = best; s < best + need; s++) owner[s] = (int16_t)h;
+  e.slot = (int16_t)best;
+  cur.bytesRead += e.storedBytes;
+  return true;
+}
+
+bool AssetStore::readInto(const Entry& e, uint8_t* dst) {
+  const bool indexed = e.kind == Kind::Sprite && e.format != SpriteAsset::Format::Rgb565;
+  if (!indexed) return device.read(e.offset, dst, e.storedBytes);
+
+  // Paleta osobno, indeksy i maska na koniec okna: dekodowanie do przodu
+  // nigdy nie nadpisuje jeszcze nieprzeczytanych indeksów, a maska od razu
+  // leży na swoim miejscu za pikselami.
+  const size_t paletteBytes = (size_t)e.paletteSize * 2;
+  const size_t rest = e.storedBytes - paletteBytes;
+  uint8_t* tail = dst + e.bytes - rest;
+  if (!device.read(e.offset, palette, paletteBytes)) return false;
+  if (!device.read(e.offset + (uint32_t)paletteBytes, tail, rest)) return false;
+
+  const SpriteAsset src{e.format, e.w, e.h, e.frames, 0, 0, false, 0, nullptr, tail, palette,
+                        e.paletteSize, nullptr, SpriteLayer::Blend::Key, nullptr, nullptr};
+  src.decode((uint16_t*)dst);
+  return true;
+}
+
+void AssetStore::evict(AssetHandle h) {
+  Entry& e = dir[h];
+  if (e.slot < 0) return;
+  const int need = e.bytes ? (int)((e.bytes + slotBytes - 1) / slotBytes) : 1;
+  for (int s = e.slot; s < e.slot + need && s < slots; s++) {
+    if (owner[s] == (int16_t)h) owner[s] = -1;
+  }
+  e.slot = -1;
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "AnimatedSprite.h"
+#include "BlockDevice.h"
+#include "SpriteAsset.h"
+#include "Sprites.h"
+
+using AssetHandle = uint16_t;
+constexpr AssetHandle kNoAsset = 0xFFFF;
+
+// Sprites and data blobs (e.g. tilemap chunks) streamed from an IBlockDevice
+// into a fixed LRU cache, for art that does not fit in internal flash.
+//
+// The cache is a caller-provided arena split into slots of slotBytes; an
+// asset takes as many consecutive slots as its decoded size needs and is
+// loaded (and indexed sprites expanded to RGB565) on first use. Eviction
+// picks the least recently used run of slots, never touching assets that are
+// pinned or were used in the current frame, so:
+//   - pointers from data() stay valid until the end of the frame
+//     (the next beginFrame());
+//   - bindSprite() pins the asset, so sprite pixels (and sheet() frames for
+//     AnimatedSprite) stay valid until unbind().
+// Scenes queue prefetch() hints in onEnter(); beginFrame() loads queued
+// assets up to the prefetch budget per frame.
+//
+// Pack format (sgfasset --pack), little-endian:
+//   header, 16 bytes: "SGFP", u16 version (1), u16 count, u32 directory
+//                     offset, u32 reserved
+//   directory, count * 32 bytes:
+//     u32 offset, u32 stored bytes, u32 decoded bytes,
+//     u16 w, u16 h, u16 frames, i16 anchorX, i16 anchorY,
+//     u16 transparent, u16 palette size, u16 span bytes,
+//     u8 kind (0 sprite, 1 blob), u8 format (SpriteAsset::Format),
+//     u8 mask (0 none/key, 1 Mask1, 2 Mask4), u8 flags (bit 0: keyed)
+//   Decoded sprite: [frames * w * h RGB565][alpha mask][opaque spans].
+//   Stored Rgb565 sprites and blobs are the decoded bytes; indexed sprites
+//   are [palette][indices][alpha mask].
+class AssetStore {
+public:
+  static constexpr int kMaxSlots = 64;
+  static constexpr int kMaxPrefetch = 16;
+  static constexpr uint16_t kVersion = 1;
+  static constexpr uint32_t kHeaderBytes = 16;
+  static constexpr uint32_t kEntryBytes = 32;
+
+  enum class Kind : uint8_t {
+    Sprite,
+    Blob,
+  };
+
+  struct Entry {
+    uint32_t offset;
+    uint32_t storedBytes;
+    uint32_t bytes;  // decoded size in the cache
+    uint16_t w;      // sprite size, or blob dimensions (e.g. tiles) for the caller
+    uint16_t h;
+    uint16_t frames;
+    int16_t anchorX;
+    int16_t anchorY;
+    uint16_t transparent;
+    uint16_t paletteSize;
+    uint16_t spanBytes;
+    Kind kind;
+    SpriteAsset::Format format;
+    SpriteLayer::Blend blend;
+    bool keyed;
+
+    // Cache state.
+    int16_t slot;
+    uint8_t pins;
+    uint32_t lastUse;
+    uint32_t usedFrame;
+  };
+
+  struct Stats {
+    uint32_t frames;
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t bytesRead;      // demand loads and prefetch
+    uint32_t prefetchBytes;
+    uint32_t evictions;
+    uint32_t failures;       // loads that did not fit or failed to read
+
+    // Percent x100 (10000 = every access hit, also when there were none).
+    uint32_t hitRateX100() const { return hits + misses ? (uint32_t)((uint64_t)hits * 10000u / (hits + misses)) : 10000u; }
+  };
+
+  // directory needs one Entry per asset in the pack; arena should be 4-byte
+  // aligned, and at most kMaxSlots slots are used.
+  AssetStore(IBlockDevice& device, Entry* directory, int capacity, uint8_t* arena, size_t arenaBytes,
+             size_t slotBytes = 1024);
+
+  // Reads the pack header and directory; false for a missing or
+  // incompatible pack, or more assets than capacity.
+  bool open();
+  int count() const { return assetCount; }
+  const Entry* entry(AssetHandle h) const { return h < assetCount ? &dir[h] : nullptr; }
+  int slotCount() const { return slots; }
+  size_t slotSize() const { return slotBytes; }
+
+  // Ends the previous frame's statistics and runs queued prefetches.
+  void beginFrame();
+
+  // Cached bytes of an asset, loading it on a miss; nullptr if it cannot be
+  // loaded. Valid until the next beginFrame() unless pinned.
+  const uint8_t* data(AssetHandle h);
+  bool resident(AssetHandle h) const { return h < assetCount && dir[h].slot >= 0; }
+
+  // SpriteAsset view of a cached sprite (Rgb565, pixels in the cache).
+  bool asset(AssetHandle h, SpriteAsset* out);
+
+  bool pin(AssetHandle h);
+  void unpin(AssetHandle h);
+
+  // Pins the sprite asset and fills s like SpriteAsset::applyTo.
+  bool bindSprite(AssetHandle h, SpriteLayer::Sprite& s);
+  void unbind(AssetHandle h) { unpin(h); }
+  // Frames of a pinned sprite asset for AnimatedSprite.
+  SpriteSheet sheet(AssetHandle h);
+
+  // Queues h to be loaded by beginFrame(); false when the queue is full.
+  bool prefetch(AssetHandle h);
+  void prefetch(const AssetHandle* list, int n) {
+    for (int i = 0; i < n; i++) prefetch(list[i]);
+  }
+  // Bytes loaded by prefetch per beginFrame() (at least one asset); 0 = all.
+  void setPrefetchBudget(uint32_t bytes) { prefetchBudget = bytes; }
+  int prefetchPending() const { return queueCount; }
+
+  // Drops every unpinned asset.
+  void evictAll();
+
+  const Stats& frameStats() const { return last; }  // previous frame
+  const Stats& totals() const { return total; }
+
+private:
+  bool load(AssetHandle h);
+  bool readInto(const Entry& e, uint8_t* dst);
+  void evict(AssetHandle h);
+  void touch(Entry& e) {
+    e.lastUse = ++tick;
+    e.usedFrame = frame;
+  }
+
+  IBlockDevice& device;
+  Entry* dir;
+  int capacity;
+  int assetCount = 0;
+  uint8_t* arena;
+  size_t slotBytes;
+  int slots;
+  int16_t owner[kMaxSlots];
+
+  AssetHandle queue[kMaxPrefetch];
+  int queueHead = 0;
+  int queueCount = 0;
+  uint32_t prefetchBudget = 4096;
+
+  uint32_t tick = 0;
+  uint32_t frame = 1;
+  Stats cur{};
+  Stats last{};
+  Stats total{};
+  uint16_t palette[256];
+};
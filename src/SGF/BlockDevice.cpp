@@ -0,0 +1,39 @@
+#include "BlockDevice.h"
+
+bool FileBlockDevice::open(const char* path) {
+  close();
+  file = fopen(path, "rb");
+  if (!file) return false;
+  if (fseek(file, 0, SEEK_END) != 0) {
+    close();
+    return false;
+  }
+  const long end = ftell(file);
+  if (end < 0 || fseek(file, 0, SEEK_SET) != 0) {
+    close();
+    return false;
+  }
+  len = (uint32_t)end;
+  pos = 0;
+  return true;
+}
+
+void FileBlockDevice::close() {
+  if (file) fclose(file);
+  file = nullptr;
+  len = 0;
+  pos = 0;
+}
+
+bool FileBlockDevice::read(uint32_t offset, void* dst, size_t n) {
+  if (!file || offset > len || n > len - offset) return false;
+  if (offset != pos && fseek(file, (long)offset, SEEK_SET) != 0) return false;
+  const size_t got = fread(dst, 1, n, file);
+  pos = offset + (uint32_t)got;
+  return got == n;
+}
+
+bool FlashBlockDevice::read(uint32_t offset, void* dst, size_t n) {
+  if (!dev || offset > len || n > len - offset) return false;
+  return flash_read(dev, (off_t)(base + offset), dst, n) == 0;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+extern "C" {
+  #include <zephyr/device.h>
+  #include <zephyr/drivers/flash.h>
+}
+
+// Random-access read-only storage for AssetStore: external SPI flash, an SD
+// card file, or a file on the host. read() returns false on any error,
+// including reads past size().
+class IBlockDevice {
+public:
+  virtual ~IBlockDevice() = default;
+  virtual uint32_t size() const = 0;
+  virtual bool read(uint32_t offset, void* dst, size_t len) = 0;
+};
+
+// Image in addressable memory (internal flash or RAM), e.g. for host tests.
+class MemoryBlockDevice : public IBlockDevice {
+public:
+  MemoryBlockDevice(const uint8_t* data, uint32_t len) : data(data), len(len) {}
+
+  uint32_t size() const override { return len; }
+  bool read(uint32_t offset, void* dst, size_t n) override {
+    if (offset > len || n > len - offset) return false;
+    memcpy(dst, data + offset, n);
+    return true;
+  }
+
+private:
+  const uint8_t* data;
+  uint32_t len;
+};
+
+// stdio file: the pack on the host, or on a mounted file system on device.
+class FileBlockDevice : public IBlockDevice {
+public:
+  FileBlockDevice() = default;
+  ~FileBlockDevice() override { close(); }
+
+  bool open(const char* path);
+  void close();
+  bool isOpen() const { return file != nullptr; }
+
+  uint32_t size() const override { return len; }
+  bool read(uint32_t offset, void* dst, size_t n) override;
+
+private:
+  FILE* file = nullptr;
+  uint32_t len = 0;
+  uint32_t pos = 0;  // current file position, saves a seek for sequential reads
+};
+
+// Window [base, base + size) of a Zephyr flash device (e.g. a SPI NOR on the
+// flash_read() API).
+class FlashBlockDevice : public IBlockDevice {
+public:
+  FlashBlockDevice(const struct device* dev, uint32_t base, uint32_t len) : dev(dev), base(base), len(len) {}
+
+  bool begin() const { return dev && device_is_ready(dev); }
+  uint32_t size() const override { return len; }
+  bool read(uint32_t offset, void* dst, size_t n) override;
+
+private:
+  const struct device* dev;
+  uint32_t base;
+  uint32_t len;
+};
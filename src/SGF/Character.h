@@ -1,5 +1,6 @@
 #pragma once
 
+#include "SGF/EntityStore.h"
 #include "SGF/Vector2.h"
 
 class Character {
@@ -9,7 +10,7 @@ public:
   virtual ~Character() = default;
 
   Vector2 getPosition() const {
-    return Position{posX, posY};
+    return Position{positionX(), positionY()};
   }
 
   void setPosition(const Position& pos) {
@@ -17,26 +18,69 @@ public:
   }
 
   void setX(int newX) {
-    setPosition(newX, posY);
+    setPosition(newX, positionY());
   }
 
   void setY(int newY) {
-    setPosition(posX, newY);
+    setPosition(positionX(), newY);
   }
 
   void setPosition(int newX, int newY) {
+    if (EntityStore* entities = entityStore()) {
+      entities->setPosition(entityId, newX, newY);
+    }
     posX = newX;
     posY = newY;
     didSetPosition();
   }
 
+  // Makes the character a handle to an EntityStore entity; with kInvalid a new
+  // entity is created at the current position. Batch systems of the store then
+  // move it without calling didSetPosition(). Once the entity is destroyed
+  // (even if its id is reused) the character falls back to its own position,
+  // the last one set through it.
+  bool attach(EntityStore& entities, EntityStore::Id id = EntityStore::kInvalid) {
+    if (id == EntityStore::kInvalid) {
+      id = entities.create(positionX(), positionY());
+    }
+    if (!entities.alive(id)) {
+      return false;
+    }
+    store = &entities;
+    entityId = id;
+    entityGen = entities.generation(id);
+    return true;
+  }
+
+  // Copies the position back into the character; the entity is left alive.
+  void detach() {
+    if (EntityStore* entities = entityStore()) {
+      posX = entities->x(entityId);
+      posY = entities->y(entityId);
+    }
+    store = nullptr;
+    entityId = EntityStore::kInvalid;
+  }
+
+  // kInvalid when not attached or the entity was destroyed.
+  EntityStore::Id entity() const {
+    return entityStore() ? entityId : EntityStore::kInvalid;
+  }
+
 protected:
+  // nullptr when not attached or the entity was destroyed.
+  EntityStore* entityStore() const {
+    return store && store->alive(entityId, entityGen) ? store : nullptr;
+  }
+
   int positionX() const {
-    return posX;
+    const EntityStore* entities = entityStore();
+    return entities ? entities->x(entityId) : posX;
   }
 
   int positionY() const {
-    return posY;
+    const EntityStore* entities = entityStore();
+    return entities ? entities->y(entityId) : posY;
   }
 
 private:
@@ -44,4 +88,7 @@ private:
 
   int posX = 0;
   int posY = 0;
+  EntityStore* store = nullptr;
+  EntityStore::Id entityId = EntityStore::kInvalid;
+  uint16_t entityGen = 0;
 };
@@ -31,6 +31,28 @@ bool pointInRect(int px, int py, int x0, int y0, int x1, int y1) {
   return px >= x0 && px <= x1 && py >= y0 && py <= y1;
 }
 
+bool maskHit(const uint8_t* a, int aw, int ah, int ax, int ay, const uint8_t* b, int bw, int bh, int bx, int by) {
+  if (!a || !b) return false;
+  const int x0 = ax > bx ? ax : bx;
+  const int y0 = ay > by ? ay : by;
+  const int x1 = (ax + aw < bx + bw ? ax + aw : bx + bw) - 1;
+  const int y1 = (ay + ah < by + bh ? ay + ah : by + bh) - 1;
+  if (x0 > x1 || y0 > y1) return false;
+
+  const int aStride = (aw + 7) / 8;
+  const int bStride = (bw + 7) / 8;
+  for (int y = y0; y <= y1; y++) {
+    const uint8_t* ra = a + (y - ay) * aStride;
+    const uint8_t* rb = b + (y - by) * bStride;
+    for (int x = x0; x <= x1; x++) {
+      const int pa = x - ax;
+      const int pb = x - bx;
+      if ((ra[pa >> 3] & (0x80u >> (pa & 7))) && (rb[pb >> 3] & (0x80u >> (pb & 7)))) return true;
+    }
+  }
+  return false;
+}
+
 bool raycastToRect(int ox, int oy, int dx, int dy, int x0, int y0, int x1, int y1, float* tHit) {
   // Liang-Barsky / slab method for axis-aligned rect. Returns first hit t in [0,1] if provided.
   float t0 = 0.0f, t1 = 1.0f;
@@ -56,3 +78,164 @@ bool raycastToRect(int ox, int oy, int dx, int dy, int x0, int y0, int x1, int y
   if (tHit) *tHit = t0;
   return true;
 }
+
+namespace {
+
+// Floor division for b > 0 (boxes may hang over the left or top edge).
+inline int32_t floorDiv(int32_t a, int32_t b) { return a >= 0 ? a / b : -((-a + b - 1) / b); }
+
+}  // namespace
+
+TileGrid::TileGrid(const uint8_t* solid, int cols, int rows, int tileW, int tileH)
+  : bits(solid),
+    nCols(solid && cols > 0 ? cols : 0),
+    nRows(solid && rows > 0 ? rows : 0),
+    stride((nCols + 7) / 8),
+    tileW(tileW > 0 ? tileW : 1),
+    tileH(tileH > 0 ? tileH : 1) {}
+
+bool TileGrid::columnHit(int col, int row0, int row1) const {
+  if (col < 0 || col >= nCols) return outsideSolid;
+  if (row0 < 0 || row1 >= nRows) {
+    if (outsideSolid) return true;
+    if (row0 < 0) row0 = 0;
+    if (row1 >= nRows) row1 = nRows - 1;
+  }
+  const uint8_t* p = bits + row0 * stride + (col >> 3);
+  const uint8_t bit = (uint8_t)(0x80u >> (col & 7));
+  for (int r = row0; r <= row1; r++, p += stride) {
+    if (*p & bit) return true;
+  }
+  return false;
+}
+
+bool TileGrid::rowHit(int row, int col0, int col1) const {
+  if (row < 0 || row >= nRows) return outsideSolid;
+  if (col0 < 0 || col1 >= nCols) {
+    if (outsideSolid) return true;
+    if (col0 < 0) col0 = 0;
+    if (col1 >= nCols) col1 = nCols - 1;
+  }
+  const uint8_t* p = bits + row * stride;
+  for (int c = col0; c <= col1; c++) {
+    if (p[c >> 3] & (0x80u >> (c & 7))) return true;
+  }
+  return false;
+}
+
+bool TileGrid::pointHit(int px, int py) const {
+  return solidTile(floorDiv(px, tileW), floorDiv(py, tileH));
+}
+
+bool TileGrid::boxHit(int x0, int y0, int x1, int y1) const {
+  if (x1 < x0 || y1 < y0) return false;
+  const int c0 = floorDiv(x0, tileW);
+  const int c1 = floorDiv(x1, tileW);
+  for (int r = floorDiv(y0, tileH); r <= floorDiv(y1, tileH); r++) {
+    if (rowHit(r, c0, c1)) return true;
+  }
+  return false;
+}
+
+TileGrid::Sweep TileGrid::sweep(int32_t x, int32_t y, int w, int h, int32_t dx, int32_t dy) const {
+  Sweep res{x, y, 0, 0, false};
+  if (w <= 0 || h <= 0) {
+    res.x += dx;
+    res.y += dy;
+    return res;
+  }
+
+  const int32_t tw = (int32_t)tileW << kFracBits;
+  const int32_t th = (int32_t)tileH << kFracBits;
+  const int32_t bw = (int32_t)w << kFracBits;
+  const int32_t bh = (int32_t)h << kFracBits;
+  int32_t remX = dx;
+  int32_t remY = dy;
+
+  // DDA po granicach kafli: krawędź wiodąca przechodzi do kolejnej kolumny
+  // albo wiersza, sprawdzamy tylko nowo wchodzące kafle.
+  while (remX || remY) {
+    const int32_t ax = remX < 0 ? -remX : remX;
+    const int32_t ay = remY < 0 ? -remY : remY;
+    int64_t distX = -1;
+    int64_t distY = -1;
+    if (remX > 0) distX = (int64_t)(floorDiv(x + bw - 1, tw) + 1) * tw - (x + bw - 1);
+    if (remX < 0) distX = (int64_t)x - (int64_t)floorDiv(x, tw) * tw + 1;
+    if (remY > 0) distY = (int64_t)(floorDiv(y + bh - 1, th) + 1) * th - (y + bh - 1);
+    if (remY < 0) distY = (int64_t)y - (int64_t)floorDiv(y, th) * th + 1;
+    if (distX > ax) distX = -1;
+    if (distY > ay) distY = -1;
+
+    if (distX < 0 && distY < 0) {
+      x += remX;
+      y += remY;
+      break;
+    }
+
+    if (distX >= 0 && distY >= 0 && distX * ay == distY * ax) {
+      // Obie krawędzie wiodące wchodzą w nowy kafel naraz: nowa kolumna (bez
+      // nowego wiersza), nowy wiersz (bez nowej kolumny) i kafel narożny.
+      const int signX = remX > 0 ? 1 : -1;
+      const int signY = remY > 0 ? 1 : -1;
+      x += signX * (int32_t)distX;
+      y += signY * (int32_t)distY;
+      remX -= signX * (int32_t)distX;
+      remY -= signY * (int32_t)distY;
+      const int c0 = floorDiv(x, tw);
+      const int c1 = floorDiv(x + bw - 1, tw);
+      const int r0 = floorDiv(y, th);
+      const int r1 = floorDiv(y + bh - 1, th);
+      const int col = signX > 0 ? c1 : c0;
+      const int row = signY > 0 ? r1 : r0;
+      const bool wallX = r0 < r1 && columnHit(col, signY > 0 ? r0 : r0 + 1, signY > 0 ? r1 - 1 : r1);
+      const bool wallY = c0 < c1 && rowHit(row, signX > 0 ? c0 : c0 + 1, signX > 0 ? c1 - 1 : c1);
+      // Sam narożnik zatrzymuje ruch w pionie (lądowanie na krawędzi półki).
+      const bool blockY = wallY || (!wallX && solidTile(col, row));
+      if (wallX) {
+        x -= signX;
+        remX = 0;
+        res.normalX = (int8_t)-signX;
+        res.hit = true;
+      }
+      if (blockY) {
+        y -= signY;
+        remY = 0;
+        res.normalY = (int8_t)-signY;
+        res.hit = true;
+      }
+    } else if (distX >= 0 && (distY < 0 || distX * ay < distY * ax)) {
+      const int sign = remX > 0 ? 1 : -1;
+      const int32_t sx = sign * (int32_t)distX;
+      const int32_t sy = (int32_t)((int64_t)remY * distX / ax);
+      x += sx;
+      y += sy;
+      remX -= sx;
+      remY -= sy;
+      const int col = sign > 0 ? floorDiv(x + bw - 1, tw) : floorDiv(x, tw);
+      if (columnHit(col, floorDiv(y, th), floorDiv(y + bh - 1, th))) {
+        x -= sign;  // tuż przed ścianą
+        remX = 0;
+        res.normalX = (int8_t)-sign;
+        res.hit = true;
+      }
+    } else {
+      const int sign = remY > 0 ? 1 : -1;
+      const int32_t sy = sign * (int32_t)distY;
+      const int32_t sx = (int32_t)((int64_t)remX * distY / ay);
+      x += sx;
+      y += sy;
+      remX -= sx;
+      remY -= sy;
+      const int row = sign > 0 ? floorDiv(y + bh - 1, th) : floorDiv(y, th);
+      if (rowHit(row, floorDiv(x, tw), floorDiv(x + bw - 1, tw))) {
+        y -= sign;
+        remY = 0;
+        res.normalY = (int8_t)-sign;
+        res.hit = true;
+      }
+    }
+  }
+  res.x = x;
+  res.y = y;
+  return res;
+}
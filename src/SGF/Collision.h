@@ -1,9 +1,66 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
 
 bool circleRectHit(int cx, int cy, int r, int x0, int y0, int x1, int y1);
 bool aabbHit(int ax0, int ay0, int ax1, int ay1, int bx0, int by0, int bx1, int by1);
 bool circleCircleHit(int ax, int ay, int ar, int bx, int by, int br);
 bool pointInRect(int px, int py, int x0, int y0, int x1, int y1);
+// Pixel-exact overlap of two 1-bit masks (rows padded to bytes, MSB first,
+// the Blend::Mask1 layout) placed with their top-left corners at (ax, ay) and
+// (bx, by).
+bool maskHit(const uint8_t* a, int aw, int ah, int ax, int ay, const uint8_t* b, int bw, int bh, int bx, int by);
 bool raycastToRect(int ox, int oy, int dx, int dy, int x0, int y0, int x1, int y1, float* tHit);
+
+// Level collision over a solid-tile bitmap: 1 bit per tile, rows padded to
+// bytes, MSB first (the Mask1 layout, one bit per tile). Tiles outside the
+// grid count as solid unless setOutsideSolid(false).
+//
+// Queries take pixel coordinates with inclusive boxes, like aabbHit();
+// sweep() moves a w x h box in 24.8 fixed point (as EntityStore) and walks
+// only the tile columns and rows its leading edges cross, in the order they
+// are crossed. A blocked axis is clamped against the tile face and its motion
+// dropped, the other axis keeps sliding. When both leading edges cross at
+// once, the entered column, the entered row and the corner tile are checked
+// together; a hit on the corner tile alone stops the vertical motion. A box
+// that starts inside a solid tile is not pushed out (check with boxHit()).
+class TileGrid {
+public:
+  static constexpr int kFracBits = 8;
+
+  struct Sweep {
+    int32_t x;       // resolved top-left, 24.8
+    int32_t y;
+    int8_t normalX;  // contact normals of the blocking faces, 0 when free
+    int8_t normalY;
+    bool hit;
+  };
+
+  TileGrid(const uint8_t* solid, int cols, int rows, int tileW, int tileH);
+
+  void setOutsideSolid(bool solidOutside) { outsideSolid = solidOutside; }
+  int cols() const { return nCols; }
+  int rows() const { return nRows; }
+
+  bool solidTile(int col, int row) const {
+    if (col < 0 || row < 0 || col >= nCols || row >= nRows) return outsideSolid;
+    return (bits[row * stride + (col >> 3)] & (0x80u >> (col & 7))) != 0;
+  }
+
+  bool pointHit(int px, int py) const;
+  bool boxHit(int x0, int y0, int x1, int y1) const;
+  Sweep sweep(int32_t x, int32_t y, int w, int h, int32_t dx, int32_t dy) const;
+
+private:
+  bool columnHit(int col, int row0, int row1) const;
+  bool rowHit(int row, int col0, int col1) const;
+
+  const uint8_t* bits;
+  int nCols;
+  int nRows;
+  int stride;
+  int tileW;
+  int tileH;
+  bool outsideSolid = true;
+};
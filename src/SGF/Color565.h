@@ -44,4 +44,48 @@ constexpr uint16_t darken(uint16_t c) {
   return static_cast<uint16_t>((r << 11) | (g << 5) | b);
 }
 
+// Blending. Alpha is 0..32 (0 = dst, 32 = src).
+// Single-pixel kernels spread the pixel to 0x07E0F81F (G in the upper half) so
+// every channel has guard bits for the 5-bit alpha product; that is one pixel
+// per 32-bit word and one multiply per pixel.
+constexpr uint32_t expand(uint16_t c) {
+  return (((uint32_t)c << 16) | c) & 0x07E0F81Fu;
+}
+
+constexpr uint16_t compress(uint32_t x) {
+  return static_cast<uint16_t>((x & 0xFFFFu) | (x >> 16));
+}
+
+constexpr uint16_t blend(uint16_t dst, uint16_t src, uint8_t alpha) {
+  uint32_t d = expand(dst);
+  uint32_t s = expand(src);
+  return compress((d + (((s - d) * alpha) >> 5)) & 0x07E0F81Fu);
+}
+
+// Two pixels packed in one word (lo | hi << 16), per-channel saturating add.
+// Each field is added without its MSB (no carry can cross fields), the MSB is
+// folded back in with xor, and fields that carried out are filled with ones.
+constexpr uint32_t addSat2(uint32_t a, uint32_t b) {
+  constexpr uint32_t MSB = 0x84108410u;     // R bit 15, G bit 10, B bit 4
+  constexpr uint32_t MSB_RB = 0x80108010u;
+  constexpr uint32_t MSB_G = 0x04000400u;
+  uint32_t low = (a & ~MSB) + (b & ~MSB);
+  uint32_t sum = low ^ ((a ^ b) & MSB);
+  uint32_t carry = ((a & b) | ((a ^ b) & low)) & MSB;
+  uint32_t fill = (carry << 1) - ((carry & MSB_RB) >> 4) - ((carry & MSB_G) >> 5);
+  return sum | fill;
+}
+
+constexpr uint16_t addSat(uint16_t a, uint16_t b) {
+  return static_cast<uint16_t>(addSat2(a, b));
+}
+
+// Per-channel product normalised so that white is the identity.
+constexpr uint16_t multiply(uint16_t a, uint16_t b) {
+  uint32_t r = ((uint32_t)(a >> 11) * (b >> 11) + 31u) >> 5;
+  uint32_t g = ((uint32_t)((a >> 5) & 0x3F) * ((b >> 5) & 0x3F) + 63u) >> 6;
+  uint32_t bl = ((uint32_t)(a & 0x1F) * (b & 0x1F) + 31u) >> 5;
+  return static_cast<uint16_t>((r << 11) | (g << 5) | bl);
+}
+
 }  // namespace Color565
@@ -57,6 +57,19 @@ void DirtyRects::clip(int w, int h) {
   }
 }
 
+void DirtyRects::snap(int cellW, int cellH, int w, int h) {
+  if (cellW <= 0 || cellH <= 0) return;
+  for (int i=0;i<n;i++) {
+    int x0 = (r[i].x0 / cellW) * cellW;
+    int y0 = (r[i].y0 / cellH) * cellH;
+    int x1 = (r[i].x1 / cellW + 1) * cellW - 1;
+    int y1 = (r[i].y1 / cellH + 1) * cellH - 1;
+    if (x1 >= w) x1 = w-1;
+    if (y1 >= h) y1 = h-1;
+    r[i] = Rect{(int16_t)x0,(int16_t)y0,(int16_t)x1,(int16_t)y1};
+  }
+}
+
 void DirtyRects::mergeAll() {
   bool changed = true;
   while (changed) {
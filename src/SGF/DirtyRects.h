@@ -20,6 +20,8 @@ public:
 
   bool add(int x0, int y0, int x1, int y1);
   void clip(int w, int h);
+  // Rozszerza recty do granic siatki cellW x cellH (przycięte do w x h).
+  void snap(int cellW, int cellH, int w, int h);
 
   int count() const { return n; }
   const Rect& operator[](int i) const { return r[i]; }
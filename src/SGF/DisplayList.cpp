@@ -0,0 +1,275 @@
+#include "DisplayList.h"
+
+#include <stdint.h>
+
+#include "Font5x7.h"
+
+namespace {
+
+inline uint32_t mix(uint32_t h, uint32_t v) {
+  h ^= v;
+  h *= 16777619u;
+  return h;
+}
+
+}  // namespace
+
+DisplayList::DisplayList(int screenW, int screenH, int tileW, int tileH)
+  : screenW(screenW), screenH(screenH), tileW(tileW > 0 ? tileW : 1), tileH(tileH > 0 ? tileH : 1) {
+  cols = (screenW + this->tileW - 1) / this->tileW;
+  rows = (screenH + this->tileH - 1) / this->tileH;
+  if (cols * rows > kMaxBins) {
+    cols = 0;
+    rows = 0;
+  }
+  invalidate();
+}
+
+void DisplayList::invalidate() {
+  for (int i = 0; i < kMaxBins; i++) prevHash[i] = 0;
+}
+
+void DisplayList::begin() {
+  cmdCount = 0;
+  textLen = 0;
+  overflow = false;
+  binsReady = false;
+}
+
+DisplayList::Command* DisplayList::push(Op op, int x0, int y0, int x1, int y1, uint16_t color) {
+  if (cmdCount >= kMaxCommands) {
+    overflow = true;
+    return nullptr;
+  }
+  Command& c = cmds[cmdCount];
+  c = Command{};
+  c.op = op;
+  c.color = color;
+  c.x0 = (int16_t)x0;
+  c.y0 = (int16_t)y0;
+  c.x1 = (int16_t)x1;
+  c.y1 = (int16_t)y1;
+  return &c;
+}
+
+void DisplayList::finishCommand(Command& c) {
+  uint32_t h = 2166136261u;
+  h = mix(h, (uint32_t)c.op | ((uint32_t)c.scale << 8) | ((uint32_t)c.color << 16));
+  h = mix(h, (uint32_t)(uint16_t)c.x0 | ((uint32_t)(uint16_t)c.y0 << 16));
+  h = mix(h, (uint32_t)(uint16_t)c.x1 | ((uint32_t)(uint16_t)c.y1 << 16));
+  h = mix(h, (uint32_t)(uint16_t)c.ax | ((uint32_t)(uint16_t)c.ay << 16));
+  h = mix(h, (uint32_t)(uint16_t)c.bx | ((uint32_t)(uint16_t)c.by << 16));
+  h = mix(h, (uint32_t)(uintptr_t)c.pixels);
+  h = mix(h, c.transparent);
+  if (c.op == Op::Text) {
+    for (const char* p = textBytes + c.textOffset; *p; ++p) h = mix(h, (uint8_t)*p);
+  }
+  c.hash = h;
+  cmdCount++;
+}
+
+bool DisplayList::fillRect(int x, int y, int w, int h, uint16_t color565) {
+  if (w <= 0 || h <= 0) return false;
+  Command* c = push(Op::FillRect, x, y, x + w - 1, y + h - 1, color565);
+  if (!c) return false;
+  finishCommand(*c);
+  return true;
+}
+
+bool DisplayList::sprite(int x, int y, int w, int h, const uint16_t* pixels565, uint16_t transparent) {
+  if (!pixels565 || w <= 0 || h <= 0) return false;
+  Command* c = push(Op::Sprite, x, y, x + w - 1, y + h - 1, 0);
+  if (!c) return false;
+  c->ax = (int16_t)w;
+  c->ay = (int16_t)h;
+  c->pixels = pixels565;
+  c->transparent = transparent;
+  finishCommand(*c);
+  return true;
+}
+
+bool DisplayList::text(int x, int y, const char* s, int scale, uint16_t color565) {
+  if (!s || !*s || scale <= 0 || scale > 255) return false;
+  int len = 0;
+  while (s[len]) len++;
+  if (textLen + len + 1 > kMaxTextBytes) {
+    overflow = true;
+    return false;
+  }
+  int w = Font5x7::textWidth(s, scale);
+  Command* c = push(Op::Text, x, y, x + w - 1, y + 7 * scale - 1, color565);
+  if (!c) return false;
+  c->scale = (uint8_t)scale;
+  c->textOffset = (uint16_t)textLen;
+  for (int i = 0; i <= len; i++) textBytes[textLen + i] = s[i];
+  textLen += len + 1;
+  finishCommand(*c);
+  return true;
+}
+
+bool DisplayList::line(int x0, int y0, int x1, int y1, uint16_t color565) {
+  int minX = x0 < x1 ? x0 : x1;
+  int maxX = x0 < x1 ? x1 : x0;
+  int minY = y0 < y1 ? y0 : y1;
+  int maxY = y0 < y1 ? y1 : y0;
+  Command* c = push(Op::Line, minX, minY, maxX, maxY, color565);
+  if (!c) return false;
+  c->ax = (int16_t)x0;
+  c->ay = (int16_t)y0;
+  c->bx = (int16_t)x1;
+  c->by = (int16_t)y1;
+  finishCommand(*c);
+  return true;
+}
+
+bool DisplayList::binRange(const Command& c, int* bx0, int* by0, int* bx1, int* by1) const {
+  int x0 = c.x0 < 0 ? 0 : c.x0;
+  int y0 = c.y0 < 0 ? 0 : c.y0;
+  int x1 = c.x1 >= screenW ? screenW - 1 : c.x1;
+  int y1 = c.y1 >= screenH ? screenH - 1 : c.y1;
+  if (x1 < x0 || y1 < y0) return false;
+  *bx0 = x0 / tileW;
+  *by0 = y0 / tileH;
+  *bx1 = x1 / tileW;
+  *by1 = y1 / tileH;
+  return true;
+}
+
+bool DisplayList::buildBins() {
+  const int nb = cols * rows;
+  if (nb <= 0) return false;
+  for (int b = 0; b <= nb; b++) binStart[b] = 0;
+
+  // Zliczanie: binStart[b + 1] = liczba komend w binie b.
+  int total = 0;
+  for (int i = 0; i < cmdCount; i++) {
+    int bx0, by0, bx1, by1;
+    if (!binRange(cmds[i], &bx0, &by0, &bx1, &by1)) continue;
+    for (int by = by0; by <= by1; by++) {
+      for (int bx = bx0; bx <= bx1; bx++) binStart[by * cols + bx + 1]++;
+    }
+    total += (bx1 - bx0 + 1) * (by1 - by0 + 1);
+    if (total > kMaxBinRefs) return false;
+  }
+  for (int b = 0; b < nb; b++) binStart[b + 1] += binStart[b];
+
+  // Wypełnianie od końca, żeby w binie zachować kolejność rysowania.
+  for (int i = cmdCount - 1; i >= 0; i--) {
+    int bx0, by0, bx1, by1;
+    if (!binRange(cmds[i], &bx0, &by0, &bx1, &by1)) continue;
+    for (int by = by0; by <= by1; by++) {
+      for (int bx = bx0; bx <= bx1; bx++) binRefs[--binStart[by * cols + bx + 1]] = (uint16_t)i;
+    }
+  }
+  for (int b = 0; b < nb; b++) binStart[b] = binStart[b + 1];
+  binStart[nb] = (uint16_t)total;
+  return true;
+}
+
+void DisplayList::end(DirtyRects& dirty) {
+  const int nb = cols * rows;
+  binsReady = !overflow && buildBins();
+
+  if (!binsReady) {
+    // Brak binów: odrysuj cały ekran i wymuś porównanie od zera w następnej klatce.
+    fallbackCount++;
+    invalidate();
+    dirty.add(0, 0, screenW - 1, screenH - 1);
+    return;
+  }
+
+  for (int b = 0; b < nb; b++) {
+    uint32_t h = mix(2166136261u, clearColor);
+    for (int i = binStart[b]; i < binStart[b + 1]; i++) h = mix(h, cmds[binRefs[i]].hash);
+    if (h == 0) h = 1;
+    if (h == prevHash[b]) continue;
+    prevHash[b] = h;
+
+    int x0 = (b % cols) * tileW;
+    int y0 = (b / cols) * tileH;
+    dirty.add(x0, y0, x0 + tileW - 1, y0 + tileH - 1);
+  }
+}
+
+void DisplayList::renderRegion(int x0, int y0, int w, int h, uint16_t* buf) const {
+  if (!buf || w <= 0 || h <= 0) return;
+  for (int i = 0; i < w * h; i++) buf[i] = clearColor;
+
+  const int x1 = x0 + w - 1;
+  const int y1 = y0 + h - 1;
+  if (binsReady && x0 >= 0 && y0 >= 0 && x1 < screenW && y1 < screenH &&
+      x0 / tileW == x1 / tileW && y0 / tileH == y1 / tileH) {
+    const int b = (y0 / tileH) * cols + x0 / tileW;
+    for (int i = binStart[b]; i < binStart[b + 1]; i++) drawCommand(cmds[binRefs[i]], x0, y0, w, h, buf);
+    return;
+  }
+
+  for (int i = 0; i < cmdCount; i++) {
+    const Command& c = cmds[i];
+    if (c.x1 < x0 || c.x0 > x1 || c.y1 < y0 || c.y0 > y1) continue;
+    drawCommand(c, x0, y0, w, h, buf);
+  }
+}
+
+void DisplayList::drawCommand(const Command& c, int x0, int y0, int w, int h, uint16_t* buf) const {
+  const int rx0 = c.x0 > x0 ? c.x0 : x0;
+  const int ry0 = c.y0 > y0 ? c.y0 : y0;
+  const int rx1 = c.x1 < x0 + w - 1 ? c.x1 : x0 + w - 1;
+  const int ry1 = c.y1 < y0 + h - 1 ? c.y1 : y0 + h - 1;
+  if (rx1 < rx0 || ry1 < ry0) return;
+
+  switch (c.op) {
+    case Op::FillRect:
+      for (int yy = ry0; yy <= ry1; yy++) {
+        uint16_t* row = buf + (yy - y0) * w;
+        for (int xx = rx0; xx <= rx1; xx++) row[xx - x0] = c.color;
+      }
+      break;
+
+    case Op::Sprite:
+      for (int yy = ry0; yy <= ry1; yy++) {
+        const uint16_t* src = c.pixels + (yy - c.y0) * c.ax;
+        uint16_t* row = buf + (yy - y0) * w;
+        for (int xx = rx0; xx <= rx1; xx++) {
+          uint16_t px = src[xx - c.x0];
+          if (px != c.transparent) row[xx - x0] = px;
+        }
+      }
+      break;
+
+    case Op::Text: {
+      const char* s = textBytes + c.textOffset;
+      for (int yy = ry0; yy <= ry1; yy++) {
+        uint16_t* row = buf + (yy - y0) * w;
+        for (int xx = rx0; xx <= rx1; xx++) {
+          if (Font5x7::textPixel(s, c.scale, xx - c.x0, yy - c.y0)) row[xx - x0] = c.color;
+        }
+      }
+      break;
+    }
+
+    case Op::Line: {
+      int x = c.ax;
+      int y = c.ay;
+      const int dx = c.bx > c.ax ? c.bx - c.ax : c.ax - c.bx;
+      const int dy = c.by > c.ay ? c.ay - c.by : c.by - c.ay;  // -|dy|
+      const int sx = c.ax < c.bx ? 1 : -1;
+      const int sy = c.ay < c.by ? 1 : -1;
+      int err = dx + dy;
+      while (true) {
+        if (x >= rx0 && x <= rx1 && y >= ry0 && y <= ry1) buf[(y - y0) * w + (x - x0)] = c.color;
+        if (x == c.bx && y == c.by) break;
+        int e2 = 2 * err;
+        if (e2 >= dy) {
+          err += dy;
+          x += sx;
+        }
+        if (e2 <= dx) {
+          err += dx;
+          y += sy;
+        }
+      }
+      break;
+    }
+  }
+}
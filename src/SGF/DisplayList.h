@@ -0,0 +1,99 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "DirtyRects.h"
+
+// Recorded display list with per-tile binning.
+// Record fillRect/sprite/text/line commands between begin() and end() (typically
+// in onProcess), then let TileFlusher replay them per tile through renderRegion().
+// end() bins commands into a tileW x tileH screen grid, hashes every bin and adds
+// a dirty rect for each bin whose content differs from the previous frame, so the
+// game no longer has to maintain DirtyRects by hand.
+//
+// Use the same tile size for the TileFlusher: the emitted dirty rects are aligned
+// to the grid, so each flushed tile replays a single bin. Text is copied into the
+// list; sprite pixels are referenced and compared by pointer.
+class DisplayList {
+public:
+  static constexpr int kMaxCommands = 128;
+  static constexpr int kMaxTextBytes = 256;
+  // A screen grid with more than kMaxBins tiles (e.g. 320x240 with 8x8 or
+  // 16x8 tiles) cannot be binned: valid() is false and every end() repaints
+  // the whole screen. Frames with more than kMaxBinRefs command/tile pairs, or
+  // more than kMaxCommands commands, fall back the same way; fullRepaints()
+  // counts them.
+  static constexpr int kMaxBins = 320;      // e.g. 320x240 with 16x16 tiles
+  static constexpr int kMaxBinRefs = 768;
+
+  DisplayList(int screenW, int screenH, int tileW, int tileH);
+
+  void setClearColor(uint16_t color565) { clearColor = color565; }
+
+  void begin();
+  bool fillRect(int x, int y, int w, int h, uint16_t color565);
+  bool sprite(int x, int y, int w, int h, const uint16_t* pixels565, uint16_t transparent);
+  bool text(int x, int y, const char* s, int scale, uint16_t color565);
+  bool line(int x0, int y0, int x1, int y1, uint16_t color565);
+  void end(DirtyRects& dirty);
+
+  // Forces every bin dirty on the next end() (screen changed outside the list).
+  void invalidate();
+
+  void renderRegion(int x0, int y0, int w, int h, uint16_t* buf) const;
+
+  int commandCount() const { return cmdCount; }
+  bool overflowed() const { return overflow; }
+  // The tile grid fits in kMaxBins.
+  bool valid() const { return cols > 0; }
+  // The last end() binned the frame (false: it repainted the whole screen).
+  bool binned() const { return binsReady; }
+  // end() calls that fell back to a full-screen repaint.
+  uint32_t fullRepaints() const { return fallbackCount; }
+
+private:
+  enum class Op : uint8_t {
+    FillRect,
+    Sprite,
+    Text,
+    Line,
+  };
+
+  struct Command {
+    Op op;
+    uint8_t scale;
+    uint16_t color;
+    int16_t x0, y0, x1, y1;  // inclusive bounds
+    int16_t ax, ay, bx, by;  // line endpoints / sprite size
+    const uint16_t* pixels;
+    uint16_t textOffset;
+    uint16_t transparent;
+    uint32_t hash;
+  };
+
+  int screenW;
+  int screenH;
+  int tileW;
+  int tileH;
+  int cols;
+  int rows;
+  uint16_t clearColor = 0;
+
+  Command cmds[kMaxCommands];
+  int cmdCount = 0;
+  char textBytes[kMaxTextBytes];
+  int textLen = 0;
+  bool overflow = false;
+  bool binsReady = false;
+  uint32_t fallbackCount = 0;
+
+  uint16_t binStart[kMaxBins + 1];
+  uint16_t binRefs[kMaxBinRefs];
+  uint32_t prevHash[kMaxBins];
+
+  Command* push(Op op, int x0, int y0, int x1, int y1, uint16_t color);
+  void finishCommand(Command& c);
+  bool binRange(const Command& c, int* bx0, int* by0, int* bx1, int* by1) const;
+  bool buildBins();
+  void drawCommand(const Command& c, int x0, int y0, int w, int h, uint16_t* buf) const;
+};
@@ -0,0 +1,124 @@
+#include "EntityStore.h"
+
+namespace {
+
+int32_t clampVelocity(int32_t v) {
+  return v < -32767 ? -32767 : (v > 32767 ? 32767 : v);
+}
+
+}  // namespace
+
+EntityStore::EntityStore(const Columns& columns, int capacity)
+  : cols(columns), cap(capacity > 0x7FFF ? 0x7FFF : capacity) {}
+
+void EntityStore::clear() {
+  for (int i = 0; i < cap; i++) {
+    if (cols.generation && cols.alive[i]) cols.generation[i]++;
+    cols.posX[i] = 0;
+    cols.posY[i] = 0;
+    cols.velX[i] = 0;
+    cols.velY[i] = 0;
+    cols.sprite[i] = -1;
+    cols.alive[i] = 0;
+    cols.nextFree[i] = kInvalid;
+  }
+  live = 0;
+  highWater = 0;
+  freeHead = kInvalid;
+}
+
+EntityStore::Id EntityStore::create(int x, int y, int spriteSlot) {
+  Id id = kInvalid;
+  if (freeHead != kInvalid) {
+    id = freeHead;
+    freeHead = cols.nextFree[id];
+  } else if (highWater < cap) {
+    id = (Id)highWater++;
+  } else {
+    return kInvalid;
+  }
+
+  cols.posX[id] = (int32_t)x * 256;
+  cols.posY[id] = (int32_t)y * 256;
+  cols.velX[id] = 0;
+  cols.velY[id] = 0;
+  if (spriteSlot < -1 || spriteSlot >= SpriteLayer::kMaxSprites) spriteSlot = -1;
+  cols.sprite[id] = (int8_t)spriteSlot;
+  cols.alive[id] = 1;
+  cols.nextFree[id] = kInvalid;
+  live++;
+  return id;
+}
+
+void EntityStore::destroy(Id id) {
+  if (!alive(id)) return;
+  // Martwe wpisy mają zerową prędkość i brak sprite'a, więc systemy
+  // mogą je przechodzić bez rozgałęzień.
+  cols.alive[id] = 0;
+  cols.velX[id] = 0;
+  cols.velY[id] = 0;
+  cols.sprite[id] = -1;
+  if (cols.generation) cols.generation[id]++;
+  cols.nextFree[id] = freeHead;
+  freeHead = id;
+  live--;
+}
+
+void EntityStore::setPosition(Id id, int x, int y) {
+  if (!valid(id)) return;
+  cols.posX[id] = (int32_t)x * 256;
+  cols.posY[id] = (int32_t)y * 256;
+}
+
+void EntityStore::setVelocity(Id id, int vxPxS, int vyPxS) {
+  if (!alive(id)) return;
+  cols.velX[id] = clampVelocity((int32_t)vxPxS * 16);
+  cols.velY[id] = clampVelocity((int32_t)vyPxS * 16);
+}
+
+void EntityStore::bindSprite(Id id, int spriteSlot) {
+  if (!alive(id)) return;
+  if (spriteSlot < -1 || spriteSlot >= SpriteLayer::kMaxSprites) spriteSlot = -1;
+  cols.sprite[id] = (int8_t)spriteSlot;
+}
+
+void EntityStore::integrate(uint32_t dtUs) {
+  if (dtUs == 0) return;
+  if (dtUs > 500000u) dtUs = 500000u;
+
+  const int32_t dt = (int32_t)(((uint64_t)dtUs << 16) / 1000000u);  // Q16 s
+  int32_t* px = cols.posX;
+  int32_t* py = cols.posY;
+  const int32_t* vx = cols.velX;
+  const int32_t* vy = cols.velY;
+  const int n = highWater;
+  for (int i = 0; i < n; i++) {
+    px[i] += (vx[i] * dt) >> 12;  // Q4 * Q16 >> 12 = Q8
+    py[i] += (vy[i] * dt) >> 12;
+  }
+}
+
+void EntityStore::syncSprites(SpriteLayer& layer, DirtyRects* dirty, int pad) const {
+  const int n = highWater;
+  for (int i = 0; i < n; i++) {
+    const int slot = cols.sprite[i];
+    if (slot < 0) continue;
+
+    SpriteLayer::Sprite& s = layer.sprite(slot);
+    const int nx = cols.posX[i] >> 8;
+    const int ny = cols.posY[i] >> 8;
+    if (s.active && s.x == nx && s.y == ny) continue;
+
+    int x0, y0, x1, y1;
+    if (dirty && s.active) {
+      SpriteLayer::spriteBoundsPadded(s, pad, &x0, &y0, &x1, &y1);
+      dirty->add(x0, y0, x1, y1);
+    }
+    s.active = true;
+    s.setPosition(nx, ny);
+    if (dirty) {
+      SpriteLayer::spriteBoundsPadded(s, pad, &x0, &y0, &x1, &y1);
+      dirty->add(x0, y0, x1, y1);
+    }
+  }
+}
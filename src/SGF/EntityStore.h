@@ -0,0 +1,87 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "DirtyRects.h"
+#include "Sprites.h"
+
+// Fixed-capacity component store for moving entities.
+// Positions (24.8 fixed point), velocities (1/16 px/s) and SpriteLayer slot
+// indices live in parallel arrays; batch systems walk them linearly instead of
+// going through one virtual Character::setPosition per object. Ids stay stable
+// until destroy() and are recycled through a free list; destroy() bumps the
+// id's generation, so a handle that keeps (id, generation()) can tell its
+// entity from a later one reusing the id.
+//
+// Use EntityStorage<N> for the backing arrays. Character / SpriteCharacter can
+// be attached to an entity and then act as thin handles into the store.
+class EntityStore {
+public:
+  using Id = int16_t;
+  static constexpr Id kInvalid = -1;
+
+  struct Columns {
+    int32_t* posX;
+    int32_t* posY;
+    int32_t* velX;
+    int32_t* velY;
+    int8_t* sprite;
+    uint8_t* alive;
+    int16_t* nextFree;
+    uint16_t* generation;  // optional; nullptr = generations stay 0
+  };
+
+  EntityStore(const Columns& columns, int capacity);
+
+  void clear();
+  Id create(int x, int y, int spriteSlot = -1);
+  void destroy(Id id);
+  bool alive(Id id) const { return valid(id) && cols.alive[id]; }
+  bool alive(Id id, uint16_t gen) const { return alive(id) && generation(id) == gen; }
+  uint16_t generation(Id id) const { return valid(id) && cols.generation ? cols.generation[id] : 0; }
+
+  int x(Id id) const { return valid(id) ? (cols.posX[id] >> 8) : 0; }
+  int y(Id id) const { return valid(id) ? (cols.posY[id] >> 8) : 0; }
+  void setPosition(Id id, int x, int y);
+  void setVelocity(Id id, int vxPxS, int vyPxS);
+  void bindSprite(Id id, int spriteSlot);  // -1 unbinds
+  int spriteSlot(Id id) const { return valid(id) ? cols.sprite[id] : -1; }
+
+  // Systems, each one linear pass over [0, highWater).
+  void integrate(uint32_t dtUs);
+  // Copies positions of bound entities into their SpriteLayer slots. When dirty
+  // is given, adds the old and new bounds (padded) of every sprite that moved.
+  void syncSprites(SpriteLayer& layer, DirtyRects* dirty = nullptr, int pad = 0) const;
+
+  int capacity() const { return cap; }
+  int count() const { return live; }
+
+private:
+  bool valid(Id id) const { return id >= 0 && id < cap; }
+
+  Columns cols;
+  int cap;
+  int live = 0;
+  int highWater = 0;
+  Id freeHead = kInvalid;
+};
+
+template <int N>
+class EntityStorage : public EntityStore {
+public:
+  EntityStorage()
+    : EntityStore(Columns{posX, posY, velX, velY, sprite, aliveFlags, nextFree, generations}, N) {
+    for (int i = 0; i < N; i++) generations[i] = 0;
+    clear();
+  }
+
+private:
+  int32_t posX[N];
+  int32_t posY[N];
+  int32_t velX[N];
+  int32_t velY[N];
+  int8_t sprite[N];
+  uint8_t aliveFlags[N];
+  int16_t nextFree[N];
+  uint16_t generations[N];
+};
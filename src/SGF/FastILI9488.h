@@ -0,0 +1,7 @@
+#pragma once
+#include "PanelDriver.h"
+#include "PanelTraits.h"
+#include "SpiBus.h"
+
+// ILI9488 480x320 on the Zephyr SPI bus; pixels are sent as RGB666.
+using FastILI9488 = PanelDriver<PanelILI9488, ZephyrSpiBus>;
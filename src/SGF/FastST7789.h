@@ -0,0 +1,7 @@
+#pragma once
+#include "PanelDriver.h"
+#include "PanelTraits.h"
+#include "SpiBus.h"
+
+// ST7789 240x240 IPS on the Zephyr SPI bus.
+using FastST7789 = PanelDriver<PanelST7789_240x240, ZephyrSpiBus>;
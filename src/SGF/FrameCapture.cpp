@@ -0,0 +1,102 @@
+#include "FrameCapture.h"
+
+#include <stdio.h>
+
+FrameCapture::FrameCapture(uint16_t* framebuffer, int w, int h)
+  : fb(framebuffer), w(w), h(h) {}
+
+void FrameCapture::blit565(int x0, int y0, int bw, int bh, const uint16_t* pix) {
+  if (!fb || !pix || bw <= 0 || bh <= 0) return;
+
+  pixelsPushed += (uint32_t)(bw * bh);
+  blitCount++;
+
+  for (int yy = 0; yy < bh; ++yy) {
+    int y = y0 + yy;
+    if (y < 0 || y >= h) continue;
+    const uint16_t* src = pix + yy * bw;
+    uint16_t* dst = fb + y * w;
+    for (int xx = 0; xx < bw; ++xx) {
+      int x = x0 + xx;
+      if (x < 0 || x >= w) continue;
+      dst[x] = src[xx];
+    }
+  }
+}
+
+void FrameCapture::blit565Scaled2x(int x0, int y0, int bw, int bh, const uint16_t* pix) {
+  if (!fb || !pix || bw <= 0 || bh <= 0) return;
+
+  pixelsPushed += (uint32_t)(4 * bw * bh);
+  blitCount++;
+
+  for (int yy = 0; yy < 2 * bh; ++yy) {
+    int y = 2 * y0 + yy;
+    if (y < 0 || y >= h) continue;
+    const uint16_t* src = pix + (yy / 2) * bw;
+    uint16_t* dst = fb + y * w;
+    for (int xx = 0; xx < 2 * bw; ++xx) {
+      int x = 2 * x0 + xx;
+      if (x < 0 || x >= w) continue;
+      dst[x] = src[xx / 2];
+    }
+  }
+}
+
+void FrameCapture::clear(uint16_t color565) {
+  if (!fb) return;
+  const int n = w * h;
+  for (int i = 0; i < n; i++) fb[i] = color565;
+}
+
+FrameCapture::FrameStats FrameCapture::endFrame() {
+  FrameStats s{frameIndex, hash(), pixelsPushed, blitCount};
+  frameIndex++;
+  pixelsPushed = 0;
+  blitCount = 0;
+  return s;
+}
+
+uint32_t FrameCapture::hash() const {
+  if (!fb) return 0;
+  return hash565(fb, (size_t)(w * h));
+}
+
+uint16_t FrameCapture::pixel(int x, int y) const {
+  if (!fb || x < 0 || y < 0 || x >= w || y >= h) return 0;
+  return fb[y * w + x];
+}
+
+void FrameCapture::writePPM(WriteFn write, void* user) const {
+  if (!write || !fb) return;
+
+  char header[32];
+  int n = snprintf(header, sizeof(header), "P6\n%d %d\n255\n", w, h);
+  write((const uint8_t*)header, (size_t)n, user);
+
+  uint8_t row[3 * 64];
+  for (int y = 0; y < h; ++y) {
+    for (int x = 0; x < w; x += 64) {
+      int count = (w - x < 64) ? (w - x) : 64;
+      for (int i = 0; i < count; ++i) {
+        uint16_t c = fb[y * w + x + i];
+        uint8_t r = (uint8_t)((c >> 11) & 0x1F);
+        uint8_t g = (uint8_t)((c >> 5) & 0x3F);
+        uint8_t b = (uint8_t)(c & 0x1F);
+        row[i * 3 + 0] = (uint8_t)((r << 3) | (r >> 2));
+        row[i * 3 + 1] = (uint8_t)((g << 2) | (g >> 4));
+        row[i * 3 + 2] = (uint8_t)((b << 3) | (b >> 2));
+      }
+      write(row, (size_t)(count * 3), user);
+    }
+  }
+}
+
+uint32_t FrameCapture::hash565(const uint16_t* pix, size_t count, uint32_t seed) {
+  uint32_t hv = seed;
+  for (size_t i = 0; i < count; ++i) {
+    hv ^= pix[i];
+    hv *= 16777619u;
+  }
+  return hv;
+}
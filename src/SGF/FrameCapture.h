@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "IRenderTarget.h"
+
+// In-memory render target for deterministic frame capture.
+// Blits land in a caller-provided RGB565 framebuffer; endFrame() hashes the
+// visible content and reports how many pixels were pushed since the last call.
+class FrameCapture : public IRenderTarget {
+public:
+  struct FrameStats {
+    uint32_t frame;
+    uint32_t hash;          // FNV-1a over the whole framebuffer
+    uint32_t pixelsPushed;  // sum of w*h over all blits in this frame
+    uint32_t blits;
+  };
+
+  using WriteFn = void (*)(const uint8_t* data, size_t len, void* user);
+
+  FrameCapture(uint16_t* framebuffer, int w, int h);
+
+  int width() const override { return w; }
+  int height() const override { return h; }
+  void blit565(int x0, int y0, int bw, int bh, const uint16_t* pix) override;
+  void blit565Scaled2x(int x0, int y0, int bw, int bh, const uint16_t* pix) override;
+
+  void clear(uint16_t color565);
+  FrameStats endFrame();
+
+  uint32_t hash() const;
+  uint16_t pixel(int x, int y) const;
+  const uint16_t* pixels() const { return fb; }
+
+  // Binary PPM (P6, 8-bit RGB) of the current framebuffer.
+  void writePPM(WriteFn write, void* user) const;
+
+  // FNV-1a over 16-bit pixels (also used by TileFlusher tile hashing).
+  static uint32_t hash565(const uint16_t* pix, size_t count, uint32_t seed = 2166136261u);
+
+private:
+  uint16_t* fb;
+  int w;
+  int h;
+  uint32_t frameIndex = 0;
+  uint32_t pixelsPushed = 0;
+  uint32_t blitCount = 0;
+};
@@ -2,7 +2,15 @@
 
 #include <Arduino.h>
 
+#if defined(__ZEPHYR__)
+extern "C" {
+  #include <zephyr/kernel.h>
+}
+#endif
+
+#include "DirtyRects.h"
 #include "Game.h"
+#include "TimerWheel.h"
 
 Game::Game(uint32_t defaultStepUs, uint32_t maxStepUs) {
   clock.lastUs = 0;
@@ -17,13 +25,68 @@ void Game::start() {
 }
 
 void Game::loop() {
-  float delta = tickSeconds(micros());
+  uint32_t now = nowUs();
+  float delta = tickSeconds(now);
+  if (timers) timers->advance(now);
   onPhysics(delta);
+  if (watchedDirty && watchedDirty->count() > 0) activeThisFrame = true;
   onProcess(delta);
+  pace(now);
+}
+
+void Game::setFramePacing(uint32_t targetUs, uint32_t idleUs, uint16_t idleAfterFrames) {
+  targetFrameUs = targetUs;
+  idleFrameUs = idleUs;
+  idleAfter = idleAfterFrames;
+  quietFrames = 0;
+}
+
+void Game::pace(uint32_t startUs) {
+  const uint32_t busy = nowUs() - startUs;
+
+  if (activeThisFrame) {
+    quietFrames = 0;
+  } else if (quietFrames < 0xFFFF) {
+    quietFrames++;
+  }
+  activeThisFrame = false;
+
+  const bool idle = idling() && idleFrameUs != 0;
+  const uint32_t budget = idle ? idleFrameUs : targetFrameUs;
+  uint32_t slept = 0;
+  if (budget > busy) {
+    const uint32_t before = nowUs();
+    sleepUs(budget - busy);
+    slept = nowUs() - before;
+  }
+
+  stats.busyUs = busy;
+  stats.sleepUs = slept;
+  stats.frameUs = busy + slept;
+  stats.dutyPermille = stats.frameUs ? (uint16_t)(((uint64_t)busy * 1000u) / stats.frameUs) : 1000;
+  stats.idle = idle;
+}
+
+void Game::sleepUs(uint32_t us) {
+  if (sleepFn) {
+    sleepFn(us);
+    return;
+  }
+#if defined(__ZEPHYR__)
+  k_usleep((int32_t)us);
+#else
+  // delay() lets the core idle; the sub-millisecond rest is not worth a busy-wait.
+  delay(us / 1000u);
+#endif
 }
 
 void Game::resetClock() {
-  clock.lastUs = micros();
+  clock.lastUs = nowUs();
+  if (timers) timers->resync(clock.lastUs);
+}
+
+uint32_t Game::nowUs() const {
+  return clockFn ? clockFn() : (uint32_t)micros();
 }
 
 float Game::tickSeconds(uint32_t nowUs) {
@@ -2,16 +2,50 @@
 
 #include <stdint.h>
 
+class DirtyRects;
+class TimerWheel;
+
 class Game {
 public:
+  // Microsecond clock source; nullptr means Arduino micros().
+  using ClockFn = uint32_t (*)();
+  // Sleep used for frame pacing; nullptr means k_usleep() on Zephyr, delay()
+  // elsewhere. Hosts with a fake clock install one that advances it.
+  using SleepFn = void (*)(uint32_t us);
+
+  struct FrameStats {
+    uint32_t frameUs;       // loop() start to end, including sleep
+    uint32_t busyUs;        // physics + process
+    uint32_t sleepUs;       // time spent sleeping
+    uint16_t dutyPermille;  // busyUs / frameUs * 1000
+    bool idle;              // paced at the idle rate
+  };
+
   Game(uint32_t defaultStepUs, uint32_t maxStepUs);
   virtual ~Game() = default;
 
   void start();
   void loop();
   void resetClock();
+  void setClock(ClockFn fn) { clockFn = fn; }
+  // Advanced with the frame clock at the start of every loop() (optional).
+  void setTimers(TimerWheel* wheel) { timers = wheel; }
+
+  // Frame pacing: after onProcess() loop() sleeps for the rest of
+  // targetFrameUs (0 = run flat out). After idleAfterFrames quiet frames (no
+  // markActive() call and no dirty rects in the watched DirtyRects after
+  // onPhysics) it paces at idleFrameUs instead, until activity resumes.
+  void setFramePacing(uint32_t targetFrameUs, uint32_t idleFrameUs = 0, uint16_t idleAfterFrames = 0);
+  void setSleep(SleepFn fn) { sleepFn = fn; }
+  void watchDirty(const DirtyRects* dirty) { watchedDirty = dirty; }
+  // Call on input (or anything else that should keep the full frame rate).
+  void markActive() { activeThisFrame = true; }
+  bool idling() const { return quietFrames >= idleAfter && idleAfter != 0; }
+  const FrameStats& frameStats() const { return stats; }
 
 protected:
+  uint32_t nowUs() const;
+
   virtual void onSetup() = 0;
   virtual void onPhysics(float delta) = 0;
   virtual void onProcess(float delta) = 0;
@@ -24,6 +58,19 @@ private:
   };
 
   FrameClock clock;
+  ClockFn clockFn = nullptr;
+  TimerWheel* timers = nullptr;
+
+  SleepFn sleepFn = nullptr;
+  const DirtyRects* watchedDirty = nullptr;
+  uint32_t targetFrameUs = 0;
+  uint32_t idleFrameUs = 0;
+  uint16_t idleAfter = 0;
+  uint16_t quietFrames = 0;
+  bool activeThisFrame = false;
+  FrameStats stats{};
 
   float tickSeconds(uint32_t nowUs);
+  void pace(uint32_t startUs);
+  void sleepUs(uint32_t us);
 };
@@ -8,4 +8,30 @@ public:
   virtual int width() const = 0;
   virtual int height() const = 0;
   virtual void blit565(int x0, int y0, int w, int h, const uint16_t* pix) = 0;
+  // Same as blit565, but the target may use pix as scratch space and leave it modified.
+  virtual void blit565InPlace(int x0, int y0, int w, int h, uint16_t* pix) {
+    blit565(x0, y0, w, h, pix);
+  }
+  // Low-resolution blit: pix is a w x h region at (x0, y0) in half-resolution
+  // coordinates and lands on the 2w x 2h area at (2 * x0, 2 * y0), every pixel
+  // doubled in both directions. Drivers override this to expand on the fly;
+  // the default expands through a small stack buffer.
+  virtual void blit565Scaled2x(int x0, int y0, int w, int h, const uint16_t* pix) {
+    static constexpr int kChunk = 32;
+    uint16_t rows[2 * kChunk * 2];
+    for (int y = 0; y < h; y++) {
+      const uint16_t* src = pix + y * w;
+      for (int x = 0; x < w; x += kChunk) {
+        const int n = (w - x) < kChunk ? (w - x) : kChunk;
+        for (int i = 0; i < n; i++) {
+          const uint16_t c = src[x + i];
+          rows[2 * i] = c;
+          rows[2 * i + 1] = c;
+          rows[2 * n + 2 * i] = c;
+          rows[2 * n + 2 * i + 1] = c;
+        }
+        blit565(2 * (x0 + x), 2 * (y0 + y), 2 * n, 2, rows);
+      }
+    }
+  }
 };
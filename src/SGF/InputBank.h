@@ -0,0 +1,162 @@
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+
+// Whole-port reads are used where the core exposes the classic AVR-style
+// port macros; elsewhere every pin goes through digitalRead().
+#if !defined(SGF_INPUT_PORT_READ)
+#if defined(portInputRegister) && defined(digitalPinToPort) && defined(digitalPinToBitMask)
+#define SGF_INPUT_PORT_READ 1
+#else
+#define SGF_INPUT_PORT_READ 0
+#endif
+#endif
+
+// Up to 32 buttons sampled and debounced together.
+// update() takes one raw sample of all inputs (bit i = input i active), runs it
+// through 2-bit vertical counters (an input changes state after 4 consecutive
+// samples at the new level) and keeps pressed / justPressed / justReleased as
+// bitmasks. Samples are spaced debounceMs / 3 apart, so calling update() every
+// frame or faster gives the same debounce time as DebouncedInputPin.
+//
+// setSource() replaces the GPIO reads with a callback returning the raw mask,
+// e.g. for host tests or replays.
+class InputBank {
+public:
+  static constexpr int kMaxInputs = 32;
+  static constexpr int kMaxPorts = 4;
+
+  using SourceFn = uint32_t (*)(void* user);
+
+  // Returns the input index (bit number) or -1 when the bank is full.
+  int addPin(uint8_t pinNumber, bool activeLow = true) {
+    if (inputCount >= kMaxInputs) return -1;
+    const int index = inputCount++;
+    pins[index] = pinNumber;
+    if (activeLow) activeLowMask |= 1u << index;
+#if SGF_INPUT_PORT_READ
+    portSlot[index] = -1;
+    auto reg = portInputRegister(digitalPinToPort(pinNumber));
+    for (int p = 0; p < portCount; p++) {
+      if (portRegs[p] == reg) portSlot[index] = (int8_t)p;
+    }
+    if (portSlot[index] < 0 && portCount < kMaxPorts) {
+      portRegs[portCount] = reg;
+      portSlot[index] = (int8_t)portCount++;
+    }
+    portMask[index] = digitalPinToBitMask(pinNumber);
+#endif
+    return index;
+  }
+
+  void begin(uint8_t mode) const {
+    for (int i = 0; i < inputCount; i++) pinMode(pins[i], mode);
+  }
+
+  void setSource(SourceFn fn, void* user = nullptr) {
+    source = fn;
+    sourceUser = user;
+  }
+
+  void setDebounceMs(uint16_t debounceMs) {
+    sampleIntervalMs = debounceMs / 3;
+  }
+
+  void reset(uint32_t pressedNow = 0) {
+    state = pressedNow & usedMask();
+    previous = state;
+    cnt0 = 0;
+    cnt1 = 0;
+    hasSampled = false;
+  }
+
+  void resetFromPins() {
+    reset(sample());
+  }
+
+  // Raw (not debounced) mask of active inputs.
+  uint32_t sample() const {
+    if (source) return source(sourceUser) & usedMask();
+
+    uint32_t levels = 0;
+#if SGF_INPUT_PORT_READ
+    uint32_t ports[kMaxPorts];
+    for (int p = 0; p < portCount; p++) ports[p] = (uint32_t)*portRegs[p];
+    for (int i = 0; i < inputCount; i++) {
+      bool high = portSlot[i] >= 0 ? (ports[portSlot[i]] & portMask[i]) != 0
+                                   : digitalRead(pins[i]) == HIGH;
+      if (high) levels |= 1u << i;
+    }
+#else
+    for (int i = 0; i < inputCount; i++) {
+      if (digitalRead(pins[i]) == HIGH) levels |= 1u << i;
+    }
+#endif
+    return (levels ^ activeLowMask) & usedMask();
+  }
+
+  uint32_t update() {
+    return update((uint32_t)millis());
+  }
+
+  uint32_t update(uint32_t nowMs) {
+    previous = state;
+    if (hasSampled && nowMs - lastSampleMs < sampleIntervalMs) return state;
+    hasSampled = true;
+    lastSampleMs = nowMs;
+
+    // Vertical counters: bit i of (cnt1:cnt0) counts samples in which input i
+    // differed from its debounced state; the fourth one toggles it.
+    const uint32_t delta = sample() ^ state;
+    cnt1 = (cnt1 ^ cnt0) & delta;
+    cnt0 = ~cnt0 & delta;
+    state ^= delta & ~(cnt0 | cnt1);
+    return state;
+  }
+
+  uint32_t pressedMask() const { return state; }
+  uint32_t justPressedMask() const { return state & ~previous; }
+  uint32_t justReleasedMask() const { return ~state & previous; }
+
+  bool pressed(int index) const { return bit(pressedMask(), index); }
+  bool justPressed(int index) const { return bit(justPressedMask(), index); }
+  bool justReleased(int index) const { return bit(justReleasedMask(), index); }
+
+  int count() const { return inputCount; }
+  uint8_t pin(int index) const { return pins[index]; }
+
+private:
+  static bool bit(uint32_t mask, int index) {
+    return index >= 0 && index < kMaxInputs && ((mask >> index) & 1u) != 0;
+  }
+
+  uint32_t usedMask() const {
+    return inputCount >= 32 ? 0xFFFFFFFFu : ((1u << inputCount) - 1u);
+  }
+
+  uint8_t pins[kMaxInputs] = {};
+  int inputCount = 0;
+  uint32_t activeLowMask = 0;
+
+#if SGF_INPUT_PORT_READ
+  using PortReg = decltype(portInputRegister(digitalPinToPort(0)));
+  using PortMask = decltype(digitalPinToBitMask(0));
+  PortReg portRegs[kMaxPorts] = {};
+  int portCount = 0;
+  int8_t portSlot[kMaxInputs] = {};
+  PortMask portMask[kMaxInputs] = {};
+#endif
+
+  SourceFn source = nullptr;
+  void* sourceUser = nullptr;
+
+  uint16_t sampleIntervalMs = 6;
+  uint32_t lastSampleMs = 0;
+  bool hasSampled = false;
+
+  uint32_t state = 0;
+  uint32_t previous = 0;
+  uint32_t cnt0 = 0;
+  uint32_t cnt1 = 0;
+};
@@ -0,0 +1,154 @@
+#include "InputEvents.h"
+
+namespace {
+
+constexpr uint16_t kMask = InputEventQueue::kCapacity - 1;
+constexpr uint8_t kMagic[4] = {'S', 'G', 'F', 'I'};
+constexpr size_t kHeaderBytes = sizeof(kMagic) + 1;
+
+}  // namespace
+
+// --- InputEventQueue --------------------------------------------------------
+
+bool InputEventQueue::post(uint8_t input, bool pressed, uint32_t timeUs) {
+  const uint16_t h = head.load(std::memory_order_relaxed);
+  const uint16_t t = tail.load(std::memory_order_acquire);
+  if ((uint16_t)(h - t) >= kCapacity) {
+    droppedCount.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  ring[h & kMask] = InputEvent{timeUs, input, pressed};
+  head.store((uint16_t)(h + 1), std::memory_order_release);
+  return true;
+}
+
+int InputEventQueue::postChanges(uint32_t before, uint32_t after, uint32_t timeUs) {
+  uint32_t changed = before ^ after;
+  int posted = 0;
+  for (uint8_t i = 0; changed; i++, changed >>= 1) {
+    if (!(changed & 1u)) continue;
+    if (post(i, ((after >> i) & 1u) != 0, timeUs)) posted++;
+  }
+  return posted;
+}
+
+int InputEventQueue::poll(InputBank& bank, uint32_t nowUs) {
+  bank.update(nowUs / 1000u);
+  const uint32_t after = bank.pressedMask();
+  const uint32_t before = after ^ (bank.justPressedMask() | bank.justReleasedMask());
+  return postChanges(before, after, nowUs);
+}
+
+bool InputEventQueue::pop(InputEvent& out) {
+  const uint16_t t = tail.load(std::memory_order_relaxed);
+  if (t == head.load(std::memory_order_acquire)) return false;
+  out = ring[t & kMask];
+  tail.store((uint16_t)(t + 1), std::memory_order_release);
+  if (rec) rec->record(out);
+  return true;
+}
+
+int InputEventQueue::dispatch(DigitalAction* actions, int count) {
+  for (int i = 0; i < count; i++) actions[i].clearEdges();
+
+  int handled = 0;
+  InputEvent e;
+  while (pop(e)) {
+    if (e.input < count) actions[e.input].applyEvent(e.pressed);
+    handled++;
+  }
+  return handled;
+}
+
+// --- InputRecorder ----------------------------------------------------------
+
+InputRecorder::InputRecorder(uint8_t* buffer, size_t capacity) : buf(buffer), cap(buffer ? capacity : 0) {
+  start(0);
+}
+
+void InputRecorder::start(uint32_t nowUs) {
+  len = 0;
+  overflow = false;
+  lastUs = nowUs;
+  for (uint8_t b : kMagic) put(b);
+  put(kVersion);
+}
+
+bool InputRecorder::put(uint8_t b) {
+  if (len >= cap) {
+    overflow = true;
+    return false;
+  }
+  buf[len++] = b;
+  return true;
+}
+
+bool InputRecorder::record(const InputEvent& event) {
+  if (overflow || event.input > 127) return false;
+
+  // Zdarzenie zapisujemy w całości albo wcale, żeby log zawsze dał się odczytać.
+  uint8_t tmp[6];
+  int n = 0;
+  uint32_t delta = event.timeUs - lastUs;
+  do {
+    uint8_t b = (uint8_t)(delta & 0x7Fu);
+    delta >>= 7;
+    tmp[n++] = delta ? (uint8_t)(b | 0x80u) : b;
+  } while (delta);
+  tmp[n++] = (uint8_t)((event.input << 1) | (event.pressed ? 1 : 0));
+
+  if (len + (size_t)n > cap) {
+    overflow = true;
+    return false;
+  }
+  for (int i = 0; i < n; i++) buf[len++] = tmp[i];
+  lastUs = event.timeUs;
+  return true;
+}
+
+void InputRecorder::write(WriteFn write, void* user) const {
+  if (write && len) write(buf, len, user);
+}
+
+// --- InputReplayer ----------------------------------------------------------
+
+InputReplayer::InputReplayer(const uint8_t* data, size_t len) : buf(data), len(data ? len : 0) {
+  ok = this->len >= kHeaderBytes;
+  for (size_t i = 0; ok && i < sizeof(kMagic); i++) ok = buf[i] == kMagic[i];
+  ok = ok && buf[sizeof(kMagic)] == InputRecorder::kVersion;
+  start(0);
+}
+
+void InputReplayer::start(uint32_t nowUs) {
+  pos = kHeaderBytes;
+  clockUs = nowUs;
+  pendingValid = ok && readNext();
+}
+
+bool InputReplayer::readNext() {
+  uint32_t delta = 0;
+  int shift = 0;
+  while (true) {
+    if (pos >= len || shift > 28) return false;
+    uint8_t b = buf[pos++];
+    delta |= (uint32_t)(b & 0x7Fu) << shift;
+    if (!(b & 0x80u)) break;
+    shift += 7;
+  }
+  if (pos >= len) return false;
+  uint8_t code = buf[pos++];
+
+  clockUs += delta;
+  pending = InputEvent{clockUs, (uint8_t)(code >> 1), (code & 1u) != 0};
+  return true;
+}
+
+int InputReplayer::pump(InputEventQueue& queue, uint32_t nowUs) {
+  int posted = 0;
+  while (pendingValid && (int32_t)(nowUs - pending.timeUs) >= 0) {
+    if (!queue.post(pending.input, pending.pressed, pending.timeUs)) break;
+    posted++;
+    pendingValid = readNext();
+  }
+  return posted;
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+#include "Actions.h"
+#include "InputBank.h"
+
+struct InputEvent {
+  uint32_t timeUs;
+  uint8_t input;
+  bool pressed;
+};
+
+class InputRecorder;
+
+// Lock-free single-producer / single-consumer ring of timestamped input events.
+// The producer is an interrupt handler or a high-rate poll (post(), poll());
+// the game loop consumes with pop() for sub-frame timing or dispatch() to drive
+// DigitalActions. When the ring is full new events are dropped and counted.
+class InputEventQueue {
+public:
+  static constexpr int kCapacity = 64;  // power of two
+
+  // Producer side.
+  bool post(uint8_t input, bool pressed, uint32_t timeUs);
+  // Posts one event per bit that differs between the two masks.
+  int postChanges(uint32_t before, uint32_t after, uint32_t timeUs);
+  // Updates the bank and posts its debounced edges.
+  int poll(InputBank& bank, uint32_t nowUs);
+
+  // Consumer side.
+  bool pop(InputEvent& out);
+  // Clears the edges of actions[0..count), then applies every queued event in
+  // order. Events for inputs >= count are consumed and ignored.
+  int dispatch(DigitalAction* actions, int count);
+
+  // Every popped event is also appended to the recorder (consumer side only).
+  void setRecorder(InputRecorder* recorder) { rec = recorder; }
+
+  bool empty() const {
+    return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+  }
+  uint32_t dropped() const { return droppedCount.load(std::memory_order_relaxed); }
+
+private:
+  InputEvent ring[kCapacity];
+  std::atomic<uint16_t> head{0};  // next write, owned by the producer
+  std::atomic<uint16_t> tail{0};  // next read, owned by the consumer
+  std::atomic<uint32_t> droppedCount{0};
+  InputRecorder* rec = nullptr;
+};
+
+// Compact binary input log in a caller-provided buffer.
+// Layout: "SGFI", version byte, then per event a LEB128 time delta in
+// microseconds (from start() or the previous event) and one byte
+// (input << 1 | pressed). A typical event takes 2-4 bytes.
+class InputRecorder {
+public:
+  using WriteFn = void (*)(const uint8_t* data, size_t len, void* user);
+
+  static constexpr uint8_t kVersion = 1;
+
+  InputRecorder(uint8_t* buffer, size_t capacity);
+
+  void start(uint32_t nowUs);
+  bool record(const InputEvent& event);
+
+  const uint8_t* data() const { return buf; }
+  size_t size() const { return len; }
+  bool overflowed() const { return overflow; }
+  void write(WriteFn write, void* user) const;
+
+private:
+  bool put(uint8_t b);
+
+  uint8_t* buf;
+  size_t cap;
+  size_t len = 0;
+  uint32_t lastUs = 0;
+  bool overflow = false;
+};
+
+// Feeds a recorded log back into a queue. Drive it from the same clock as the
+// game (e.g. a fake clock installed with Game::setClock) for deterministic runs.
+class InputReplayer {
+public:
+  InputReplayer(const uint8_t* data, size_t len);
+
+  bool valid() const { return ok; }
+  // Event times are re-based so the log starts at nowUs.
+  void start(uint32_t nowUs);
+  // Posts every event due at nowUs; returns how many were posted.
+  int pump(InputEventQueue& queue, uint32_t nowUs);
+  bool done() const { return !pendingValid; }
+
+private:
+  bool readNext();
+
+  const uint8_t* buf;
+  size_t len;
+  size_t pos = 0;
+  bool ok = false;
+  uint32_t clockUs = 0;
+  InputEvent pending{};
+  bool pendingValid = false;
+};
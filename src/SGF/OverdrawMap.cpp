@@ -0,0 +1,212 @@
+#include "OverdrawMap.h"
+
+#include <stdio.h>
+
+namespace {
+
+// Czarny -> niebieski -> czerwony -> żółty -> biały.
+void heatColor(uint32_t t, uint8_t* rgb) {
+  if (t > 255) t = 255;
+  if (t < 64) {
+    rgb[0] = 0;
+    rgb[1] = 0;
+    rgb[2] = (uint8_t)(t * 4);
+  } else if (t < 128) {
+    rgb[0] = (uint8_t)((t - 64) * 4);
+    rgb[1] = 0;
+    rgb[2] = (uint8_t)(255 - (t - 64) * 4);
+  } else if (t < 192) {
+    rgb[0] = 255;
+    rgb[1] = (uint8_t)((t - 128) * 4);
+    rgb[2] = 0;
+  } else {
+    rgb[0] = 255;
+    rgb[1] = 255;
+    rgb[2] = (uint8_t)((t - 192) * 4);
+  }
+}
+
+}  // namespace
+
+OverdrawMap::OverdrawMap(int screenW, int screenH, int cellSize, uint16_t* sent, uint16_t* unchanged,
+                         uint16_t* shadow, uint8_t* known)
+  : w(screenW > 0 ? screenW : 0),
+    h(screenH > 0 ? screenH : 0),
+    cell(cellSize > 0 ? cellSize : 1),
+    cols((w + cell - 1) / cell),
+    rows((h + cell - 1) / cell),
+    sent(sent),
+    unchanged(unchanged),
+    shadow(shadow && known ? shadow : nullptr),
+    known(shadow && known ? known : nullptr) {
+  reset();
+  invalidateShadow();
+}
+
+void OverdrawMap::invalidateShadow() {
+  if (!known) return;
+  for (int i = 0; i < (cols * rows + 7) / 8; i++) known[i] = 0;
+}
+
+void OverdrawMap::seedShadow(uint16_t color) {
+  if (!shadow) return;
+  for (int i = 0; i < w * h; i++) shadow[i] = color;
+  for (int i = 0; i < (cols * rows + 7) / 8; i++) known[i] = 0xFF;
+}
+
+void OverdrawMap::reset() {
+  for (int i = 0; i < cols * rows; i++) {
+    sent[i] = 0;
+    unchanged[i] = 0;
+  }
+  frameCount = 0;
+  rendered = 0;
+  sentTotal = 0;
+  unchangedTotal = 0;
+  blitCount = 0;
+}
+
+void OverdrawMap::recordRendered(int rw, int rh) {
+  if (complete()) return;
+  rendered += (uint32_t)(rw * rh);
+}
+
+void OverdrawMap::recordSent(int x0, int y0, int bw, int bh, const uint16_t* pix) {
+  if (complete() || !pix) return;
+  blitCount++;
+
+  const int stride = bw;
+  int sx = 0;
+  int sy = 0;
+  if (x0 < 0) {
+    sx = -x0;
+    bw += x0;
+    x0 = 0;
+  }
+  if (y0 < 0) {
+    sy = -y0;
+    bh += y0;
+    y0 = 0;
+  }
+  if (x0 + bw > w) bw = w - x0;
+  if (y0 + bh > h) bh = h - y0;
+  if (bw <= 0 || bh <= 0) return;
+
+  sentTotal += (uint32_t)(bw * bh);
+  for (int row = 0; row < bh; row++) {
+    const int y = y0 + row;
+    uint16_t* sentRow = sent + (y / cell) * cols;
+    uint16_t* sameRow = unchanged + (y / cell) * cols;
+    const uint16_t* src = pix + (sy + row) * stride + sx;
+
+    // Zliczamy odcinkami w obrębie jednej komórki.
+    int x = x0;
+    while (x < x0 + bw) {
+      const int cx = x / cell;
+      int end = (cx + 1) * cell;
+      if (end > x0 + bw) end = x0 + bw;
+      const int n = end - x;
+      add(sentRow[cx], (uint32_t)n);
+
+      if (shadow) {
+        uint16_t* sh = shadow + y * w + x;
+        const uint16_t* s = src + (x - x0);
+        const bool compare = cellKnown(cx, y / cell);
+        uint32_t same = 0;
+        for (int i = 0; i < n; i++) {
+          if (compare && sh[i] == s[i]) same++;
+          sh[i] = s[i];
+        }
+        if (same) {
+          add(sameRow[cx], same);
+          unchangedTotal += same;
+        }
+      }
+      x = end;
+    }
+  }
+
+  // Komórki pokryte w całości tym blitem: shadow jest od teraz pewny.
+  if (shadow) {
+    const int cx0 = (x0 + cell - 1) / cell;
+    const int cy0 = (y0 + cell - 1) / cell;
+    const int xEnd = x0 + bw;
+    const int yEnd = y0 + bh;
+    for (int cy = cy0; cy < rows && ((cy + 1) * cell <= yEnd || yEnd == h); cy++) {
+      for (int cx = cx0; cx < cols && ((cx + 1) * cell <= xEnd || xEnd == w); cx++) {
+        const int i = cy * cols + cx;
+        known[i >> 3] |= (uint8_t)(1u << (i & 7));
+      }
+    }
+  }
+}
+
+void OverdrawMap::endFrame() {
+  if (complete()) return;
+  frameCount++;
+}
+
+OverdrawMap::Summary OverdrawMap::summary() const {
+  Summary s{};
+  s.frames = frameCount;
+  s.pixelsRendered = rendered;
+  s.pixelsSent = sentTotal;
+  s.pixelsUnchanged = unchangedTotal;
+  s.blits = blitCount;
+
+  const uint32_t frames = frameCount ? frameCount : 1u;
+  if (w > 0 && h > 0) s.sentPerFrameX100 = (uint32_t)((uint64_t)sentTotal * 100u / ((uint64_t)w * h * frames));
+
+  for (int cy = 0; cy < rows; cy++) {
+    const int ch = (cy + 1) * cell <= h ? cell : h - cy * cell;
+    for (int cx = 0; cx < cols; cx++) {
+      const uint16_t v = sent[cy * cols + cx];
+      if (!v) continue;
+      s.cellsTouched++;
+      const int cw = (cx + 1) * cell <= w ? cell : w - cx * cell;
+      const uint32_t x100 = (uint32_t)((uint64_t)v * 100u / ((uint64_t)(cw * ch) * frames));
+      if (x100 > s.peakCellRepaintX100) s.peakCellRepaintX100 = x100;
+    }
+  }
+  return s;
+}
+
+void OverdrawMap::writeHeatmapPPM(Channel channel, WriteFn write, void* user) const {
+  if (!write) return;
+  const uint16_t* map = channel == Channel::Repaint ? sent : unchanged;
+
+  uint32_t peak = 0;
+  for (int i = 0; i < cols * rows; i++) {
+    if (map[i] > peak) peak = map[i];
+  }
+
+  char header[32];
+  int n = snprintf(header, sizeof(header), "P6\n%d %d\n255\n", w, h);
+  write((const uint8_t*)header, (size_t)n, user);
+
+  uint8_t row[3 * 64];
+  for (int y = 0; y < h; ++y) {
+    const uint16_t* cells = map + (y / cell) * cols;
+    for (int x = 0; x < w; x += 64) {
+      int count = (w - x < 64) ? (w - x) : 64;
+      for (int i = 0; i < count; ++i) {
+        const uint16_t v = cells[(x + i) / cell];
+        heatColor(peak ? (uint32_t)v * 255u / peak : 0u, &row[i * 3]);
+      }
+      write(row, (size_t)(count * 3), user);
+    }
+  }
+}
+
+void OverdrawMap::writeSummary(WriteFn write, void* user) const {
+  if (!write) return;
+  const Summary s = summary();
+  char line[160];
+  int n = snprintf(line, sizeof(line),
+                   "frames=%lu rendered=%lu sent=%lu unchanged=%lu blits=%lu cells=%lu sent_pct=%lu peak_x100=%lu\n",
+                   (unsigned long)s.frames, (unsigned long)s.pixelsRendered, (unsigned long)s.pixelsSent,
+                   (unsigned long)s.pixelsUnchanged, (unsigned long)s.blits, (unsigned long)s.cellsTouched,
+                   (unsigned long)s.sentPerFrameX100, (unsigned long)s.peakCellRepaintX100);
+  if (n > (int)sizeof(line) - 1) n = (int)sizeof(line) - 1;
+  write((const uint8_t*)line, (size_t)n, user);
+}
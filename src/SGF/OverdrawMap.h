@@ -0,0 +1,107 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Debug instrumentation for TileFlusher (setOverdraw): counts, per cell of
+// cellSize x cellSize pixels, how many pixels were sent to the target and how
+// many of them were identical to what the target already showed, over a
+// window of frames. Use it to tune DirtyRects padding, tile sizes and merge
+// heuristics.
+//
+// All storage is caller-provided: sent and unchanged need cellCount() entries
+// (saturating 16-bit counters). The "unchanged" counts need shadow, a copy of
+// the screen (w * h pixels) the map keeps up to date, and known,
+// knownBytesFor() bytes with one bit per cell; without them only repaint
+// counts are collected. A cell's shadow is compared only once it is known:
+// after one blit covered the whole cell, or after seedShadow(). Until then
+// sent pixels just fill the shadow. Coordinates are TileFlusher's (half
+// resolution with pixel doubling).
+//
+// Host builds export the maps as PPM heatmaps (writeHeatmapPPM); on device,
+// writeSummary() prints one line of totals. Call endFrame() once per frame.
+class OverdrawMap {
+public:
+  struct Summary {
+    uint32_t frames;
+    uint32_t pixelsRendered;   // renderRegion output, including tiles skipped by hashing
+    uint32_t pixelsSent;       // pixels blitted to the target
+    uint32_t pixelsUnchanged;  // sent pixels equal to the shadow (0 without shadow)
+    uint32_t blits;
+    uint32_t cellsTouched;     // cells with at least one pixel sent
+    uint32_t sentPerFrameX100;    // pixelsSent per frame as % of the screen
+    uint32_t peakCellRepaintX100; // hottest cell: average repaints per pixel per frame x100
+  };
+
+  enum class Channel : uint8_t {
+    Repaint,
+    Unchanged,
+  };
+
+  using WriteFn = void (*)(const uint8_t* data, size_t len, void* user);
+
+  OverdrawMap(int screenW, int screenH, int cellSize, uint16_t* sent, uint16_t* unchanged,
+              uint16_t* shadow = nullptr, uint8_t* known = nullptr);
+
+  static int cellCountFor(int screenW, int screenH, int cellSize) {
+    return ((screenW + cellSize - 1) / cellSize) * ((screenH + cellSize - 1) / cellSize);
+  }
+  static int knownBytesFor(int screenW, int screenH, int cellSize) {
+    return (cellCountFor(screenW, screenH, cellSize) + 7) / 8;
+  }
+  int cellCount() const { return cols * rows; }
+  int cellSize() const { return cell; }
+
+  // Stops accumulating after frames frames (0 = never); complete() then turns true.
+  void setWindow(uint32_t frames) { windowFrames = frames; }
+  bool complete() const { return windowFrames && frameCount >= windowFrames; }
+
+  // Clears counters; the shadow keeps the current screen contents.
+  void reset();
+  // Marks the whole shadow unknown, e.g. after drawing outside the flusher.
+  void invalidateShadow();
+  // The screen is known to be filled with color (e.g. after fillScreen565):
+  // fills the shadow and marks every cell known.
+  void seedShadow(uint16_t color);
+
+  // Called by TileFlusher with the tile in normal RGB565, before the blit.
+  void recordRendered(int w, int h);
+  void recordSent(int x0, int y0, int w, int h, const uint16_t* pix);
+  // Not called by TileFlusher: the caller ends every frame (after its flush)
+  // with endFrame(). It counts frames and closes the window, so without it
+  // frames stays 0 and per-frame figures are meaningless.
+  void endFrame();
+
+  Summary summary() const;
+  uint16_t sentAt(int cellX, int cellY) const { return sent[cellY * cols + cellX]; }
+  uint16_t unchangedAt(int cellX, int cellY) const { return unchanged[cellY * cols + cellX]; }
+
+  // Binary PPM (P6) at screen resolution, black = never sent, white = the
+  // hottest cell of the channel.
+  void writeHeatmapPPM(Channel channel, WriteFn write, void* user) const;
+  // "frames=.. rendered=.. sent=.. unchanged=.. blits=.. cells=.. sent_pct=.. peak_x100=..\n"
+  void writeSummary(WriteFn write, void* user) const;
+
+private:
+  static void add(uint16_t& c, uint32_t v) {
+    uint32_t s = (uint32_t)c + v;
+    c = (uint16_t)(s > 0xFFFFu ? 0xFFFFu : s);
+  }
+
+  int w, h, cell, cols, rows;
+  uint16_t* sent;
+  uint16_t* unchanged;
+  bool cellKnown(int cx, int cy) const {
+    const int i = cy * cols + cx;
+    return (known[i >> 3] & (1u << (i & 7))) != 0;
+  }
+
+  uint16_t* shadow;
+  uint8_t* known;
+  uint32_t windowFrames = 0;
+  uint32_t frameCount = 0;
+  uint32_t rendered = 0;
+  uint32_t sentTotal = 0;
+  uint32_t unchangedTotal = 0;
+  uint32_t blitCount = 0;
+};
@@ -0,0 +1,567 @@
+#pragma once
+#include <Arduino.h>
+#include <string.h>
+
+#include "Color565.h"
+#include "Font5x7.h"
+#include "IRenderTarget.h"
+#include "PanelTraits.h"
+
+// Display driver core shared by the MIPI-DCS style SPI panels.
+// Panel is a traits struct from PanelTraits.h (size, rotations, init
+// sequence, window commands, pixel format); Bus moves the bytes (ZephyrSpiBus
+// on the board, RecordingBus on the host). Both are compile-time parameters,
+// so window setup, clipping and pixel encoding are folded per panel:
+// FastILI9341, FastST7789 and FastILI9488 are instantiations of this class.
+template <class Panel, class Bus>
+class PanelDriver : public IRenderTarget {
+public:
+  using Format = typename Panel::Format;
+
+  enum class ScreenRotation : uint8_t {
+    Landscape      = Panel::kLandscape,
+    Portrait       = Panel::kPortrait,
+    LandscapeFlip  = Panel::kLandscapeFlip,
+    PortraitFlip   = Panel::kPortraitFlip,
+  };
+  using Rotation = ScreenRotation;  // backward-compatible alias
+
+  static constexpr uint8_t MADCTL_MY  = 0x80;
+  static constexpr uint8_t MADCTL_MX  = 0x40;
+  static constexpr uint8_t MADCTL_MV  = 0x20;
+  static constexpr uint8_t MADCTL_ML  = 0x10;
+  static constexpr uint8_t MADCTL_BGR = 0x08;
+  static constexpr uint8_t MADCTL_MH  = 0x04;
+  static constexpr uint8_t BACKLIGHT_LEVEL_MIN = 0u;
+  static constexpr uint8_t BACKLIGHT_LEVEL_MAX = 255u;
+  static constexpr size_t DEFAULT_SCRATCH_PIXELS = 320;
+
+  struct BusStats {
+    uint32_t transactions;  // bus transfers (spi_write calls)
+    uint32_t chipSelects;   // CS assertions
+    uint32_t windowSkips;   // CASET/PASET skipped because the range was unchanged
+  };
+
+  // piny: CS/DC/RST/LED (RST i LED mogą być -1)
+  PanelDriver(int cs, int dc, int rst, int led)
+    : io(cs, dc), PIN_RST(rst), PIN_LED(led) {}
+
+  bool begin(uint32_t spi_hz) { return begin(spi_hz, Panel::kDefaultRotation); }
+  bool begin(uint32_t spi_hz, uint8_t madctl);
+  void setSPIFrequency(uint32_t spi_hz) { io.setFrequency(spi_hz); }
+  void screenRotation(uint8_t madctl);
+  void screenRotation(ScreenRotation rot) { screenRotation((uint8_t)rot); }
+  void setBacklight(uint8_t level);  // normalized brightness 0..BACKLIGHT_LEVEL_MAX
+  uint8_t backlight() const { return backlightLevel; }
+  void setBacklightPwmMax(uint32_t pwmMax) {
+    backlightPwmMaxValue = pwmMax ? pwmMax : (uint32_t)BACKLIGHT_LEVEL_MAX;
+  }
+  uint32_t backlightPwmMax() const { return backlightPwmMaxValue; }
+  void fadeBacklightTo(uint8_t targetLevel, uint32_t durationMs);
+  void fadeInBacklight(uint32_t durationMs) { fadeBacklightTo(BACKLIGHT_LEVEL_MAX, durationMs); }
+  void fadeOutBacklight(uint32_t durationMs) { fadeBacklightTo(BACKLIGHT_LEVEL_MIN, durationMs); }
+
+  // Scratch arena shared by all pixel operations (pixel encoding for blits,
+  // pattern for fills). Transfers are chunked to its size, so any size works;
+  // larger arenas mean fewer bus writes. nullptr restores the small built-in one.
+  void setScratch(uint16_t* buf, size_t pixels);
+  size_t scratchPixels() const { return scratchCap; }
+
+  const BusStats& busStats() const { return stats; }
+  void resetBusStats() { stats = BusStats{}; }
+  Bus& bus() { return io; }
+
+  // Square panels have a fixed size in every rotation.
+  int width() const override { return Panel::kWidth == Panel::kHeight ? Panel::kWidth : curW; }
+  int height() const override { return Panel::kWidth == Panel::kHeight ? Panel::kHeight : curH; }
+
+  void fillScreen565(uint16_t color565); // color w normalnym RGB565 (nie-swapped)
+  void fillRect565(int x0, int y0, int w, int h, uint16_t color565);
+  void drawText(int x, int y, const char* text, int scale, uint16_t color565);
+  void drawCenteredText(int y, const char* text, int scale, uint16_t color565);
+
+  // Blit: wysyła bufor RGB565 (normalny endian) do prostokąta
+  // bufor ma w*h pixeli, row-major
+  void blit565(int x0, int y0, int w, int h, const uint16_t* pix) override;
+  // RGB565 panels swap pix in place instead of copying through scratch (pix is
+  // left big-endian); other formats fall back to blit565().
+  void blit565InPlace(int x0, int y0, int w, int h, uint16_t* pix) override;
+  // Half-resolution blit: each source row is doubled horizontally while it is
+  // encoded into scratch and sent twice, all in one window.
+  void blit565Scaled2x(int x0, int y0, int w, int h, const uint16_t* pix) override;
+
+private:
+  Bus io;
+  int PIN_RST, PIN_LED;
+  int curW = Panel::kWidth;
+  int curH = Panel::kHeight;
+  int colOff = 0;
+  int rowOff = 0;
+
+  uint8_t backlightLevel = BACKLIGHT_LEVEL_MAX;
+  uint32_t backlightPwmMaxValue = BACKLIGHT_LEVEL_MAX;
+
+  uint16_t defaultScratch[DEFAULT_SCRATCH_PIXELS];
+  uint16_t* scratchBuf = defaultScratch;
+  size_t scratchCap = DEFAULT_SCRATCH_PIXELS;
+
+  // Scratch capacity in encoded pixels.
+  size_t scratchPx() const { return scratchCap * 2 / Format::kBytes; }
+  uint8_t* scratchBytes() { return reinterpret_cast<uint8_t*>(scratchBuf); }
+
+  void updateDimensions(uint8_t madctl);
+  static constexpr size_t CMD_BUF_SIZE = 16;
+  uint8_t cmdBuf[CMD_BUF_SIZE];
+  size_t cmdLen = 0;
+  bool csLow = false;
+  bool dcHigh = true;
+  bool windowValid = false;
+  int winX0 = 0, winX1 = 0, winY0 = 0, winY1 = 0;
+  BusStats stats{};
+
+  void hwReset();
+  void runInit(const uint8_t* seq, size_t len);
+  void busBegin();
+  void busEnd();
+  void setDC(bool dataMode);
+  // Komendy trafiają do cmdBuf ([cmd][n][params...]) i idą jednym CS w flushCommands().
+  // Dłuższe niż cmdBuf idą od razu po opróżnieniu bufora, pod tym samym CS.
+  void queueCommand(uint8_t c, const uint8_t* params, size_t n);
+  void flushCommands();
+  void command(uint8_t c, const uint8_t* params = nullptr, size_t n = 0);
+  // Ustawia okno i wysyła RAMWR; CS zostaje aktywny dla strumienia pikseli.
+  void setWindow(int x0,int y0,int x1,int y1);
+
+  void streamBegin();
+  void streamEnd();
+  void streamWrite(const void* encoded, size_t bytes);
+  void streamFill(uint16_t color565, size_t count);
+  bool clipRect(int& x0, int& y0, int& w, int& h, int* srcX, int* srcY) const;
+};
+
+template <class Panel, class Bus>
+void PanelDriver<Panel, Bus>::setScratch(uint16_t* buf, size_t pixels) {
+  // Minimum: dwa zakodowane piksele (podwajanie w blit565Scaled2x).
+  if (buf && pixels * 2 >= 2 * Format::kBytes) {
+    scratchBuf = buf;
+    scratchCap = pixels;
+  } else {
+    scratchBuf = defaultScratch;
+    scratchCap = DEFAULT_SCRATCH_PIXELS;
+  }
+}
+
+template <class Panel, class Bus>
+void PanelDriver<Panel, Bus>::setBacklight(uint8_t level) {
+  backlightLevel = level;
+  if (PIN_LED < 0) return;
+
+  uint32_t pwm =
+    ((uint32_t)level * backlightPwmMaxValue + (BACKLIGHT_LEVEL_MAX / 2u)) / BACKLIGHT_LEVEL_MAX;
+
+  if (pwm == 0u) {
+    digitalWrite(PIN_LED, LOW);
+    return;
+  }
+  if (pwm >= backlightPwmMaxValue) {
+    digitalWrite(PIN_LED, HIGH);
+    return;
+  }
+  analogWrite(PIN_LED, (int)pwm);
+}
+
+template <class Panel, class Bus>
+void PanelDriver<Panel, Bus>::fadeBacklightTo(uint8_t targetLevel, uint32_t durationMs) {
+  uint8_t startLevel = backlightLevel;
+  if (durationMs == 0 || startLevel == targetLevel) {
+    setBacklight(targetLevel);
+    return;
+  }
+
+  uint32_t t0 = millis();
+  while (true) {
+    uint32_t elapsed = millis() - t0;
+    if (elapsed >= durationMs) break;
+
+    int32_t dv = (int32_t)targetLevel - (int32_t)startLevel;
+    uint8_t cur = (uint8_t)((int32_t)startLevel + (dv * (int32_t)elapsed) / (int32_t)durationMs);
+    setBacklight(cur);
+    delay(1);
+  }
+
+  setBacklight(targetLevel);
+}
+
+template <class Panel, class Bus>
+void PanelDriver<Panel, Bus>::busBegin() {
+  if (csLow) return;
+  io.select(true);
+  csLow = true;
+  stats.chipSelects++;
+}
+
+template <class Panel, class Bus>
+void PanelDriver<Panel, Bus>::busEnd() {
+  if (!csLow) return;
+  io.select(false);
+  csLow = false;
+}
+
+template <class Panel, class Bus>
+void PanelDriver<Panel, Bus>::setDC(bool dataMode) {
+  if (dcHigh == dataMode) return;
+  io.dataMode(dataMode);
+  dcHigh = dataMode;
+}
+
+template <class Panel, class Bus>
+void PanelDriver<Panel, Bus>::queueCommand(uint8_t c, const uint8_t* params, size_t n) {
+  if (cmdLen + 2 + n > CMD_BUF_SIZE) flushCommands();
+  if (2 + n > CMD_BUF_SIZE) {
+    // Za długa na cmdBuf (np. gamma 0xE0/0xE1): wysyłamy od razu, w całości.
+    busBegin();
+    setDC(false);
+    stats.transactions += io.write(&c, 1);
+    setDC(true);
+    stats.transactions += io.write(params, n);
+    return;
+  }
+  cmdBuf[cmdLen++] = c;
+  cmdBuf[cmdLen++] = (uint8_t)n;
+  for (size_t i = 0; i < n; i++) cmdBuf[cmdLen++] = params[i];
+}
+
+template <class Panel, class Bus>
+void PanelDriver<Panel, Bus>::flushCommands() {
+  // Jeden CS na całą sekwencję; DC przełączamy tylko między komendą a parametrami.
+  if (cmdLen == 0) return;
+  busBegin();
+  size_t i = 0;
+  while (i < cmdLen) {
+    uint8_t n = cmdBuf[i + 1];
+    setDC(false);
+    stats.transactions += io.write(&cmdBuf[i], 1);
+    if (n > 0) {
+      setDC(true);
+      stats.transactions += io.write(&cmdBuf[i + 2], n);
+    }
+    i += 2 + n;
+  }
+  cmdLen = 0;
+}
+
+template <class Panel, class Bus>
+void PanelDriver<Panel, Bus>::command(uint8_t c, const uint8_t* params, size_t n) {
+  queueCommand(c, params, n);
+  flushCommands();
+  busEnd();
+}
+
+template <class Panel, class Bus>
+void PanelDriver<Panel, Bus>::streamBegin() {
+  busBegin();
+  setDC(true);
+}
+
+template <class Panel, class Bus>
+void PanelDriver<Panel, Bus>::streamEnd() {
+  busEnd();
+}
+
+template <class Panel, class Bus>
+void PanelDriver<Panel, Bus>::streamWrite(const void* encoded, size_t bytes) {
+  stats.transactions += io.write(encoded, bytes);
+}
+
+template <class Panel, class Bus>
+void PanelDriver<Panel, Bus>::streamFill(uint16_t color565, size_t count) {
+  // Wzorzec raz w scratchu, potem wysyłany wielokrotnie (kilka buforów na transfer).
+  if (count == 0) return;
+  const size_t cap = scratchPx();
+  const size_t pattern = (count < cap) ? count : cap;
+  alignas(uint16_t) uint8_t px[Format::kBytes];  // encode() pisze RGB565 słowami
+  Format::encode(&color565, 1, px);
+  uint8_t* dst = scratchBytes();
+  for (size_t i = 0; i < pattern; i++) memcpy(dst + i * Format::kBytes, px, Format::kBytes);
+
+  stats.transactions +=
+    io.writeRepeat(dst, pattern * Format::kBytes, count / pattern, (count % pattern) * Format::kBytes);
+}
+
+template <class Panel, class Bus>
+bool PanelDriver<Panel, Bus>::clipRect(int& x0, int& y0, int& w, int& h, int* srcX, int* srcY) const {
+  const int cw = width();
+  const int ch = height();
+  int sx = 0;
+  int sy = 0;
+  if (x0 < 0) {
+    sx = -x0;
+    w += x0;
+    x0 = 0;
+  }
+  if (y0 < 0) {
+    sy = -y0;
+    h += y0;
+    y0 = 0;
+  }
+  if (x0 >= cw || y0 >= ch) return false;
+  if (x0 + w > cw) w = cw - x0;
+  if (y0 + h > ch) h = ch - y0;
+  if (srcX) *srcX = sx;
+  if (srcY) *srcY = sy;
+  return w > 0 && h > 0;
+}
+
+template <class Panel, class Bus>
+void PanelDriver<Panel, Bus>::setWindow(int x0, int y0, int x1, int y1) {
+  // CASET/PASET tylko gdy zakres się zmienił (np. kolejne kafle w rzędzie).
+  if (!windowValid || x0 != winX0 || x1 != winX1) {
+    const int dx = Panel::kHasOffsets ? colOff : 0;
+    uint16_t xd[2] = { Color565::bswap((uint16_t)(x0 + dx)), Color565::bswap((uint16_t)(x1 + dx)) };
+    queueCommand(Panel::kCaset, (const uint8_t*)xd, 4);
+    winX0 = x0;
+    winX1 = x1;
+  } else {
+    stats.windowSkips++;
+  }
+
+  if (!windowValid || y0 != winY0 || y1 != winY1) {
+    const int dy = Panel::kHasOffsets ? rowOff : 0;
+    uint16_t yd[2] = { Color565::bswap((uint16_t)(y0 + dy)), Color565::bswap((uint16_t)(y1 + dy)) };
+    queueCommand(Panel::kRaset, (const uint8_t*)yd, 4);
+    winY0 = y0;
+    winY1 = y1;
+  } else {
+    stats.windowSkips++;
+  }
+  windowValid = true;
+
+  queueCommand(Panel::kRamwr, nullptr, 0);
+  flushCommands();
+}
+
+template <class Panel, class Bus>
+void PanelDriver<Panel, Bus>::hwReset() {
+  if (PIN_RST < 0) return;
+  digitalWrite(PIN_RST, HIGH);
+  delay(5);
+  digitalWrite(PIN_RST, LOW);
+  delay(20);
+  digitalWrite(PIN_RST, HIGH);
+  delay(120);
+}
+
+template <class Panel, class Bus>
+void PanelDriver<Panel, Bus>::runInit(const uint8_t* seq, size_t len) {
+  size_t i = 0;
+  while (i + 2 <= len) {
+    const uint8_t c = seq[i];
+    const uint8_t flags = seq[i + 1];
+    const size_t n = flags & (uint8_t)~PanelInit::kDelay;
+    i += 2;
+    command(c, n ? &seq[i] : nullptr, n);
+    i += n;
+    if ((flags & PanelInit::kDelay) && i < len) delay(seq[i++]);
+  }
+}
+
+template <class Panel, class Bus>
+void PanelDriver<Panel, Bus>::screenRotation(uint8_t madctl) {
+  command(0x36, &madctl, 1);  // MADCTL
+  windowValid = false;
+  updateDimensions(madctl);
+}
+
+template <class Panel, class Bus>
+bool PanelDriver<Panel, Bus>::begin(uint32_t spi_hz, uint8_t madctl) {
+  if (PIN_RST >= 0) pinMode(PIN_RST, OUTPUT);
+  if (PIN_LED >= 0) {
+    pinMode(PIN_LED, OUTPUT);
+    setBacklight(BACKLIGHT_LEVEL_MAX);
+  }
+
+  csLow = false;
+  dcHigh = true;
+  cmdLen = 0;
+  windowValid = false;
+  if (PIN_RST >= 0) digitalWrite(PIN_RST, HIGH);
+
+  if (!io.begin(spi_hz)) return false;
+
+  hwReset();
+  runInit(Panel::kInit, sizeof(Panel::kInit));
+
+  {
+    uint8_t col = Format::kColMod;
+    command(0x3A, &col, 1);  // COLMOD
+  }
+  delay(10);
+
+  screenRotation(madctl);
+  delay(10);
+
+  command(0x29);
+  delay(20);  // DISPON
+  updateDimensions(madctl);
+  return true;
+}
+
+template <class Panel, class Bus>
+void PanelDriver<Panel, Bus>::updateDimensions(uint8_t madctl) {
+  // Variants with MV cleared (portrait on the landscape-sized panels) expose
+  // kHeight x kWidth; with MV set, kWidth x kHeight.
+  if (madctl & MADCTL_MV) {
+    curW = Panel::kWidth;
+    curH = Panel::kHeight;
+  } else {
+    curW = Panel::kHeight;
+    curH = Panel::kWidth;
+  }
+  colOff = Panel::colOffset(madctl);
+  rowOff = Panel::rowOffset(madctl);
+}
+
+template <class Panel, class Bus>
+void PanelDriver<Panel, Bus>::fillScreen565(uint16_t color565) {
+  setWindow(0, 0, width() - 1, height() - 1);
+  streamBegin();
+  streamFill(color565, (size_t)width() * (size_t)height());
+  streamEnd();
+}
+
+template <class Panel, class Bus>
+void PanelDriver<Panel, Bus>::fillRect565(int x0, int y0, int w, int h, uint16_t color565) {
+  if (w <= 0 || h <= 0) return;
+  if (!clipRect(x0, y0, w, h, nullptr, nullptr)) return;
+
+  setWindow(x0, y0, x0 + w - 1, y0 + h - 1);
+  streamBegin();
+  streamFill(color565, (size_t)w * (size_t)h);
+  streamEnd();
+}
+
+template <class Panel, class Bus>
+void PanelDriver<Panel, Bus>::drawText(int x, int y, const char* text, int scale, uint16_t color565) {
+  if (!text || scale <= 0) return;
+
+  const int w = Font5x7::textWidth(text, scale);
+  const int h = 7 * scale;
+  for (int yy = 0; yy < h; yy++) {
+    for (int xx = 0; xx < w; xx++) {
+      if (Font5x7::textPixel(text, scale, xx, yy)) {
+        fillRect565(x + xx, y + yy, 1, 1, color565);
+      }
+    }
+  }
+}
+
+template <class Panel, class Bus>
+void PanelDriver<Panel, Bus>::drawCenteredText(int y, const char* text, int scale, uint16_t color565) {
+  if (!text) return;
+  int x = (width() - Font5x7::textWidth(text, scale)) / 2;
+  drawText(x, y, text, scale, color565);
+}
+
+template <class Panel, class Bus>
+void PanelDriver<Panel, Bus>::blit565(int x0, int y0, int w, int h, const uint16_t* pix) {
+  if (!pix || w <= 0 || h <= 0) return;
+
+  const int stride = w;
+  int sx = 0;
+  int sy = 0;
+  if (!clipRect(x0, y0, w, h, &sx, &sy)) return;
+
+  // Kodujemy do scratcha kawałkami i wysyłamy w jednym oknie,
+  // więc rozmiar blitu nie jest ograniczony scratchem.
+  setWindow(x0, y0, x0 + w - 1, y0 + h - 1);
+  streamBegin();
+  const size_t cap = scratchPx();
+  uint8_t* dst = scratchBytes();
+  size_t used = 0;
+  for (int row = 0; row < h; row++) {
+    const uint16_t* src = pix + (sy + row) * stride + sx;
+    size_t left = (size_t)w;
+    while (left > 0) {
+      size_t room = cap - used;
+      size_t n = (left < room) ? left : room;
+      Format::encode(src, n, dst + used * Format::kBytes);
+      used += n;
+      src += n;
+      left -= n;
+      if (used == cap) {
+        streamWrite(dst, used * Format::kBytes);
+        used = 0;
+      }
+    }
+  }
+  if (used > 0) streamWrite(dst, used * Format::kBytes);
+  streamEnd();
+}
+
+template <class Panel, class Bus>
+void PanelDriver<Panel, Bus>::blit565InPlace(int x0, int y0, int w, int h, uint16_t* pix) {
+  if (!pix || w <= 0 || h <= 0) return;
+  if (!Format::kInPlace || x0 < 0 || y0 < 0 || x0 + w > width() || y0 + h > height()) {
+    blit565(x0, y0, w, h, pix);
+    return;
+  }
+
+  const size_t n = (size_t)w * (size_t)h;
+  Format::encodeInPlace(pix, n);
+
+  setWindow(x0, y0, x0 + w - 1, y0 + h - 1);
+  streamBegin();
+  streamWrite(pix, n * Format::kBytes);
+  streamEnd();
+}
+
+template <class Panel, class Bus>
+void PanelDriver<Panel, Bus>::blit565Scaled2x(int x0, int y0, int w, int h, const uint16_t* pix) {
+  if (!pix || w <= 0 || h <= 0) return;
+
+  // Przycinamy w przestrzeni połówkowej, potem wszystko razy dwa.
+  const int stride = w;
+  const int halfW = width() / 2;
+  const int halfH = height() / 2;
+  int sx = 0;
+  int sy = 0;
+  if (x0 < 0) {
+    sx = -x0;
+    w += x0;
+    x0 = 0;
+  }
+  if (y0 < 0) {
+    sy = -y0;
+    h += y0;
+    y0 = 0;
+  }
+  if (x0 + w > halfW) w = halfW - x0;
+  if (y0 + h > halfH) h = halfH - y0;
+  if (w <= 0 || h <= 0) return;
+
+  setWindow(2 * x0, 2 * y0, 2 * (x0 + w) - 1, 2 * (y0 + h) - 1);
+  streamBegin();
+  const size_t cap = scratchPx();
+  uint8_t* dst = scratchBytes();
+  const size_t rowPixels = (size_t)w * 2;
+  if (rowPixels <= cap) {
+    // Cały podwojony wiersz mieści się w scratchu: jeden transfer z dwoma buforami.
+    for (int row = 0; row < h; row++) {
+      Format::encodeDoubled(pix + (sy + row) * stride + sx, (size_t)w, dst);
+      stats.transactions += io.writeRepeat(dst, rowPixels * Format::kBytes, 2);
+    }
+  } else {
+    const size_t chunk = cap / 2;
+    for (int row = 0; row < h; row++) {
+      const uint16_t* src = pix + (sy + row) * stride + sx;
+      for (int copy = 0; copy < 2; copy++) {
+        for (size_t x = 0; x < (size_t)w; x += chunk) {
+          const size_t n = ((size_t)w - x) < chunk ? ((size_t)w - x) : chunk;
+          Format::encodeDoubled(src + x, n, dst);
+          streamWrite(dst, n * 2 * Format::kBytes);
+        }
+      }
+    }
+  }
+  streamEnd();
+}
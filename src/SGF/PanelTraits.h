@@ -0,0 +1,180 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Color565.h"
+
+// Compile-time descriptions of the display panels PanelDriver can drive.
+//
+// A panel traits struct provides:
+//   kWidth, kHeight         logical size with MADCTL_MV set (landscape); MV
+//                           cleared swaps them
+//   kLandscape, kPortrait,
+//   kLandscapeFlip,
+//   kPortraitFlip           MADCTL values of the four rotations
+//   kDefaultRotation        MADCTL used by begin(hz)
+//   kCaset, kRaset, kRamwr  address window / memory write commands
+//   kInit                   init sequence run after the hardware reset:
+//                           [cmd][n | PanelInit::kDelay][n params][delay ms if flagged]...
+//                           n is 0..127; entries longer than the driver's
+//                           command buffer (e.g. 15-byte gamma tables) are
+//                           sent whole
+//   Format                  pixel format of the RAMWR stream
+//   colOffset(madctl),
+//   rowOffset(madctl)       window offset of the visible area in controller RAM
+//   kHasOffsets             false when both offsets are always 0
+//
+// COLMOD (from Format), MADCTL and DISPON are sent by the driver after kInit.
+
+namespace PanelInit {
+constexpr uint8_t kDelay = 0x80;  // n | kDelay: a delay byte (ms) follows the params
+}
+
+// 16-bit RGB565, sent big-endian. encode() writes whole words, so dst must be
+// 2-byte aligned.
+struct PixelRgb565 {
+  static constexpr uint8_t kColMod = 0x55;
+  static constexpr size_t kBytes = 2;
+  static constexpr bool kInPlace = true;  // can be swapped in the caller's buffer
+
+  static void encode(const uint16_t* src, size_t n, uint8_t* dst) {
+    uint16_t* d = reinterpret_cast<uint16_t*>(dst);
+    for (size_t i = 0; i < n; i++) d[i] = Color565::bswap(src[i]);
+  }
+  static void encodeDoubled(const uint16_t* src, size_t n, uint8_t* dst) {
+    uint16_t* d = reinterpret_cast<uint16_t*>(dst);
+    for (size_t i = 0; i < n; i++) {
+      const uint16_t c = Color565::bswap(src[i]);
+      d[2 * i] = c;
+      d[2 * i + 1] = c;
+    }
+  }
+  static void encodeInPlace(uint16_t* pix, size_t n) {
+    for (size_t i = 0; i < n; i++) pix[i] = Color565::bswap(pix[i]);
+  }
+};
+
+// 18-bit RGB666 in three bytes (the only SPI format of the ILI9488).
+struct PixelRgb666 {
+  static constexpr uint8_t kColMod = 0x66;
+  static constexpr size_t kBytes = 3;
+  static constexpr bool kInPlace = false;
+
+  static void encode(const uint16_t* src, size_t n, uint8_t* dst) {
+    for (size_t i = 0; i < n; i++) {
+      const uint16_t c = src[i];
+      *dst++ = (uint8_t)((c >> 8) & 0xF8);
+      *dst++ = (uint8_t)((c >> 3) & 0xFC);
+      *dst++ = (uint8_t)(c << 3);
+    }
+  }
+  static void encodeDoubled(const uint16_t* src, size_t n, uint8_t* dst) {
+    for (size_t i = 0; i < n; i++) {
+      const uint16_t c = src[i];
+      const uint8_t r = (uint8_t)((c >> 8) & 0xF8);
+      const uint8_t g = (uint8_t)((c >> 3) & 0xFC);
+      const uint8_t b = (uint8_t)(c << 3);
+      dst[0] = r;
+      dst[1] = g;
+      dst[2] = b;
+      dst[3] = r;
+      dst[4] = g;
+      dst[5] = b;
+      dst += 6;
+    }
+  }
+  static void encodeInPlace(uint16_t*, size_t) {}
+};
+
+// ILI9341 240x320 TFT.
+struct PanelILI9341 {
+  static constexpr int kWidth = 320;
+  static constexpr int kHeight = 240;
+
+  static constexpr uint8_t kLandscape = 0xE8;
+  static constexpr uint8_t kPortrait = 0x48;
+  static constexpr uint8_t kLandscapeFlip = 0x28;
+  static constexpr uint8_t kPortraitFlip = 0x88;
+  static constexpr uint8_t kDefaultRotation = kLandscape;
+
+  static constexpr uint8_t kCaset = 0x2A;
+  static constexpr uint8_t kRaset = 0x2B;
+  static constexpr uint8_t kRamwr = 0x2C;
+
+  static constexpr uint8_t kInit[] = {
+    0x01, 0 | PanelInit::kDelay, 150,  // SWRESET
+    0x11, 0 | PanelInit::kDelay, 120,  // SLPOUT
+  };
+
+  using Format = PixelRgb565;
+
+  static constexpr bool kHasOffsets = false;
+  static constexpr int colOffset(uint8_t) { return 0; }
+  static constexpr int rowOffset(uint8_t) { return 0; }
+};
+
+// ST7789 240x240 IPS (controller RAM is 240x320, so flipped rotations are
+// shifted by 80 lines).
+struct PanelST7789_240x240 {
+  static constexpr int kWidth = 240;
+  static constexpr int kHeight = 240;
+
+  static constexpr uint8_t kLandscape = 0x60;
+  static constexpr uint8_t kPortrait = 0x00;
+  static constexpr uint8_t kLandscapeFlip = 0xA0;
+  static constexpr uint8_t kPortraitFlip = 0xC0;
+  static constexpr uint8_t kDefaultRotation = kPortrait;
+
+  static constexpr uint8_t kCaset = 0x2A;
+  static constexpr uint8_t kRaset = 0x2B;
+  static constexpr uint8_t kRamwr = 0x2C;
+
+  static constexpr uint8_t kInit[] = {
+    0x01, 0 | PanelInit::kDelay, 150,  // SWRESET
+    0x11, 0 | PanelInit::kDelay, 120,  // SLPOUT
+    0x21, 0,                           // INVON (IPS)
+    0x13, 0 | PanelInit::kDelay, 10,   // NORON
+  };
+
+  using Format = PixelRgb565;
+
+  // MY odwraca adresowanie: widoczne 240 linii leży wtedy na końcu 320-liniowej pamięci.
+  static constexpr bool kHasOffsets = true;
+  static constexpr int colOffset(uint8_t madctl) { return ((madctl & 0xA0) == 0xA0) ? 80 : 0; }
+  static constexpr int rowOffset(uint8_t madctl) { return ((madctl & 0xA0) == 0x80) ? 80 : 0; }
+};
+
+// ILI9488 320x480 TFT on SPI (RGB666 only).
+struct PanelILI9488 {
+  static constexpr int kWidth = 480;
+  static constexpr int kHeight = 320;
+
+  static constexpr uint8_t kLandscape = 0xE8;
+  static constexpr uint8_t kPortrait = 0x48;
+  static constexpr uint8_t kLandscapeFlip = 0x28;
+  static constexpr uint8_t kPortraitFlip = 0x88;
+  static constexpr uint8_t kDefaultRotation = kLandscape;
+
+  static constexpr uint8_t kCaset = 0x2A;
+  static constexpr uint8_t kRaset = 0x2B;
+  static constexpr uint8_t kRamwr = 0x2C;
+
+  static constexpr uint8_t kInit[] = {
+    0x01, 0 | PanelInit::kDelay, 150,  // SWRESET
+    0x11, 0 | PanelInit::kDelay, 120,  // SLPOUT
+    0xC0, 2, 0x17, 0x15,               // Power Control 1
+    0xC1, 1, 0x41,                     // Power Control 2
+    0xC5, 3, 0x00, 0x12, 0x80,         // VCOM
+    0xB0, 1, 0x00,                     // Interface Mode
+    0xB1, 1, 0xA0,                     // Frame Rate 60 Hz
+    0xB4, 1, 0x02,                     // Display Inversion: 2-dot
+    0xE9, 1, 0x00,                     // Set Image Function
+    0xF7, 4, 0xA9, 0x51, 0x2C, 0x82,   // Adjust Control 3
+  };
+
+  using Format = PixelRgb666;
+
+  static constexpr bool kHasOffsets = false;
+  static constexpr int colOffset(uint8_t) { return 0; }
+  static constexpr int rowOffset(uint8_t) { return 0; }
+};
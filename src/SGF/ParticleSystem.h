@@ -0,0 +1,158 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "DirtyRects.h"
+
+// Fixed-capacity particle pool with structure-of-arrays storage.
+// Positions are 24.8 fixed point, velocities and gravity are 1/16 px/s (and
+// px/s^2). Live particles are kept dense in [0, count()): spawn appends, kill
+// moves the last particle into the hole, both O(1), and update() runs straight
+// loops over the arrays that the compiler can vectorize.
+//
+// emitDirty() adds one rect per particle cluster (up to kMaxClusters) for the
+// current positions plus the clusters from the previous call, so moved and
+// expired particles get erased. Call it once per frame after update().
+template <int N>
+class ParticleSystem {
+public:
+  static constexpr int kCapacity = N;
+  static constexpr int kMaxClusters = 8;
+  static constexpr int kClusterMargin = 8;  // px; particles this close join a cluster
+
+  void clear() { n = 0; }
+
+  bool spawn(int x, int y, int vxPxS, int vyPxS, uint32_t lifeUs, uint16_t color565) {
+    if (n >= N) return false;
+    px[n] = (int32_t)x * 256;
+    py[n] = (int32_t)y * 256;
+    vx[n] = clampV((int32_t)vxPxS * 16);
+    vy[n] = clampV((int32_t)vyPxS * 16);
+    life[n] = (int32_t)(lifeUs > 0x7FFFFFFFu ? 0x7FFFFFFFu : lifeUs);
+    color[n] = color565;
+    n++;
+    return true;
+  }
+
+  void kill(int index) {
+    if (index < 0 || index >= n) return;
+    n--;
+    px[index] = px[n];
+    py[index] = py[n];
+    vx[index] = vx[n];
+    vy[index] = vy[n];
+    life[index] = life[n];
+    color[index] = color[n];
+  }
+
+  void setGravity(int gxPxS2, int gyPxS2) {
+    gx = (int32_t)gxPxS2 * 16;
+    gy = (int32_t)gyPxS2 * 16;
+  }
+
+  void setPointSize(int size) { pointSize = size < 1 ? 1 : (size > 4 ? 4 : size); }
+
+  void update(uint32_t dtUs) {
+    if (dtUs == 0 || n == 0) return;
+    if (dtUs > 500000u) dtUs = 500000u;
+
+    const int32_t dt = (int32_t)(((uint64_t)dtUs << 16) / 1000000u);  // Q16 s
+    const int32_t dvx = (gx * dt) >> 16;
+    const int32_t dvy = (gy * dt) >> 16;
+    const int32_t dLife = (int32_t)dtUs;
+    const int count = n;
+
+    for (int i = 0; i < count; i++) {
+      vx[i] = clampV(vx[i] + dvx);
+      vy[i] = clampV(vy[i] + dvy);
+    }
+    for (int i = 0; i < count; i++) {
+      px[i] += (vx[i] * dt) >> 12;  // Q4 * Q16 >> 12 = Q8
+      py[i] += (vy[i] * dt) >> 12;
+      life[i] -= dLife;
+    }
+
+    for (int i = 0; i < n;) {
+      if (life[i] <= 0) {
+        kill(i);
+      } else {
+        i++;
+      }
+    }
+  }
+
+  void emitDirty(DirtyRects& dirty) {
+    Rect cur[kMaxClusters];
+    int curCount = 0;
+    const int ext = pointSize - 1;
+
+    for (int i = 0; i < n; i++) {
+      const int x = px[i] >> 8;
+      const int y = py[i] >> 8;
+      int best = -1;
+      int bestCost = 0x7FFFFFFF;
+      for (int c = 0; c < curCount; c++) {
+        int dx = x < cur[c].x0 ? cur[c].x0 - x : (x > cur[c].x1 ? x - cur[c].x1 : 0);
+        int dy = y < cur[c].y0 ? cur[c].y0 - y : (y > cur[c].y1 ? y - cur[c].y1 : 0);
+        int cost = dx + dy;
+        if (cost < bestCost) {
+          bestCost = cost;
+          best = c;
+        }
+      }
+      if (best < 0 || (bestCost > kClusterMargin && curCount < kMaxClusters)) {
+        cur[curCount++] = Rect{(int16_t)x, (int16_t)y, (int16_t)(x + ext), (int16_t)(y + ext)};
+        continue;
+      }
+      Rect& r = cur[best];
+      if (x < r.x0) r.x0 = (int16_t)x;
+      if (y < r.y0) r.y0 = (int16_t)y;
+      if (x + ext > r.x1) r.x1 = (int16_t)(x + ext);
+      if (y + ext > r.y1) r.y1 = (int16_t)(y + ext);
+    }
+
+    for (int c = 0; c < prevCount; c++) dirty.add(prev[c].x0, prev[c].y0, prev[c].x1, prev[c].y1);
+    for (int c = 0; c < curCount; c++) {
+      dirty.add(cur[c].x0, cur[c].y0, cur[c].x1, cur[c].y1);
+      prev[c] = cur[c];
+    }
+    prevCount = curCount;
+  }
+
+  void renderRegion(int x0, int y0, int w, int h, uint16_t* buf) const {
+    if (!buf || w <= 0 || h <= 0) return;
+    const int size = pointSize;
+    for (int i = 0; i < n; i++) {
+      const int x = (px[i] >> 8) - x0;
+      const int y = (py[i] >> 8) - y0;
+      if (x + size <= 0 || y + size <= 0 || x >= w || y >= h) continue;
+      for (int yy = y < 0 ? 0 : y; yy < y + size && yy < h; yy++) {
+        for (int xx = x < 0 ? 0 : x; xx < x + size && xx < w; xx++) buf[yy * w + xx] = color[i];
+      }
+    }
+  }
+
+  int count() const { return n; }
+  int x(int index) const { return px[index] >> 8; }
+  int y(int index) const { return py[index] >> 8; }
+
+private:
+  static int32_t clampV(int32_t v) {
+    return v < -32767 ? -32767 : (v > 32767 ? 32767 : v);
+  }
+
+  int32_t px[N];
+  int32_t py[N];
+  int32_t vx[N];
+  int32_t vy[N];
+  int32_t life[N];
+  uint16_t color[N];
+  int n = 0;
+
+  int32_t gx = 0;
+  int32_t gy = 0;
+  int pointSize = 1;
+
+  Rect prev[kMaxClusters];
+  int prevCount = 0;
+};
@@ -0,0 +1,397 @@
+#include "Primitives.h"
+
+namespace {
+
+uint32_t isqrt(uint32_t v) {
+  uint32_t res = 0;
+  uint32_t bit = 1u << 30;
+  while (bit > v) bit >>= 2;
+  while (bit) {
+    if (v >= res + bit) {
+      v -= res + bit;
+      res = (res >> 1) + bit;
+    } else {
+      res >>= 1;
+    }
+    bit >>= 2;
+  }
+  return res;
+}
+
+// Half-width of row dy of a disc of radius r; -1 when the row is outside.
+// x^2 + y^2 <= r^2 + r, i.e. the disc of radius r + 0.5 sampled at pixel centres.
+int discHalfWidth(int r, int dy) {
+  if (r < 0 || dy < -r || dy > r) return -1;
+  return (int)isqrt((uint32_t)(r * r + r - dy * dy));
+}
+
+// Span of row yy of a filled rounded rect; false when the row is outside.
+bool roundRectSpan(int x, int y, int w, int h, int radius, int yy, int* left, int* right) {
+  if (w <= 0 || h <= 0 || yy < y || yy >= y + h) return false;
+  int inset = 0;
+  if (radius > 0) {
+    const int top = y + radius;
+    const int bottom = y + h - 1 - radius;
+    const int t = yy < top ? top - yy : (yy > bottom ? yy - bottom : 0);
+    if (t) inset = radius - discHalfWidth(radius, t);
+  }
+  *left = x + inset;
+  *right = x + w - 1 - inset;
+  return true;
+}
+
+int clampRadius(int radius, int w, int h) {
+  const int m = (w < h ? w : h) / 2;
+  if (radius > m) radius = m;
+  return radius < 0 ? 0 : radius;
+}
+
+int16_t clamp16(int v) {
+  if (v < -32768) return -32768;
+  if (v > 32767) return 32767;
+  return (int16_t)v;
+}
+
+Rect makeRect(int x0, int y0, int x1, int y1) {
+  return Rect{clamp16(x0), clamp16(y0), clamp16(x1), clamp16(y1)};
+}
+
+}  // namespace
+
+namespace Raster {
+
+void hspan(const Region& r, int x0, int x1, int y, uint16_t color565) {
+  if (y < r.y0 || y >= r.y0 + r.h) return;
+  if (x0 < r.x0) x0 = r.x0;
+  if (x1 > r.x0 + r.w - 1) x1 = r.x0 + r.w - 1;
+  if (x0 > x1) return;
+  uint16_t* dst = r.buf + (y - r.y0) * r.w + (x0 - r.x0);
+  for (int n = x1 - x0 + 1; n > 0; --n) *dst++ = color565;
+}
+
+void line(const Region& r, int x0, int y0, int x1, int y1, uint16_t color565) {
+  if (!r.buf || r.w <= 0 || r.h <= 0) return;
+
+  // Oś główna a, poboczna b. Krok k ma przesunięcie poboczne
+  // m(k) = floor((2*k*db + da) / (2*da)) - jak w Bresenhamie, ale liczone
+  // z parametrów globalnych, więc każdy kafel zaczyna od pierwszego widocznego kroku.
+  const bool xMajor = (x1 > x0 ? x1 - x0 : x0 - x1) >= (y1 > y0 ? y1 - y0 : y0 - y1);
+  const int a0 = xMajor ? x0 : y0;
+  const int b0 = xMajor ? y0 : x0;
+  const int da = xMajor ? x1 - x0 : y1 - y0;
+  const int db = xMajor ? y1 - y0 : x1 - x0;
+  const int sa = da < 0 ? -1 : 1;
+  const int sb = db < 0 ? -1 : 1;
+  const int64_t ada = da < 0 ? -da : da;
+  const int64_t adb = db < 0 ? -db : db;
+
+  const int aMin = xMajor ? r.x0 : r.y0;
+  const int aMax = aMin + (xMajor ? r.w : r.h) - 1;
+  const int bMin = xMajor ? r.y0 : r.x0;
+  const int bMax = bMin + (xMajor ? r.h : r.w) - 1;
+
+  // Zakres kroków widoczny na osi głównej.
+  int64_t kLo = 0, kHi = ada;
+  {
+    const int64_t lo = sa > 0 ? aMin - a0 : a0 - aMax;
+    const int64_t hi = sa > 0 ? aMax - a0 : a0 - aMin;
+    if (lo > kLo) kLo = lo;
+    if (hi < kHi) kHi = hi;
+  }
+  // ... i na osi pobocznej (m(k) rośnie monotonicznie).
+  {
+    int64_t mLo = sb > 0 ? bMin - b0 : b0 - bMax;
+    int64_t mHi = sb > 0 ? bMax - b0 : b0 - bMin;
+    if (mLo < 0) mLo = 0;
+    if (mHi < mLo) return;
+    if (adb == 0) {
+      if (mLo > 0) return;
+    } else {
+      const int64_t num = 2 * ada * mLo - ada;
+      const int64_t lo = num <= 0 ? 0 : (num + 2 * adb - 1) / (2 * adb);
+      const int64_t hi = (2 * ada * (mHi + 1) - ada - 1) / (2 * adb);
+      if (lo > kLo) kLo = lo;
+      if (hi < kHi) kHi = hi;
+    }
+  }
+  if (kLo > kHi) return;
+
+  // Stan przyrostowy: m i reszta err = 2*k*db + da - 2*da*m, 0 <= err < 2*da.
+  const int64_t num0 = 2 * kLo * adb + ada;
+  int m = ada ? (int)(num0 / (2 * ada)) : 0;
+  int32_t err = ada ? (int32_t)(num0 - 2 * ada * m) : 0;
+  const int32_t step = (int32_t)(2 * adb);
+  const int32_t wrap = (int32_t)(2 * ada);
+
+  if (xMajor) {
+    // Kolejne piksele w tym samym wierszu składają się w jeden span.
+    int runStart = a0 + sa * (int)kLo;
+    for (int k = (int)kLo; k <= (int)kHi; ++k) {
+      int nm = m;
+      int32_t ne = err + step;
+      while (ne >= wrap && wrap) {
+        ne -= wrap;
+        nm++;
+      }
+      if (k == (int)kHi || nm != m) {
+        const int xa = a0 + sa * k;
+        hspan(r, sa > 0 ? runStart : xa, sa > 0 ? xa : runStart, b0 + sb * m, color565);
+        runStart = xa + sa;
+      }
+      m = nm;
+      err = ne;
+    }
+  } else {
+    for (int k = (int)kLo; k <= (int)kHi; ++k) {
+      const int yy = a0 + sa * k;
+      const int xx = b0 + sb * m;
+      r.buf[(yy - r.y0) * r.w + (xx - r.x0)] = color565;
+      err += step;
+      while (err >= wrap && wrap) {
+        err -= wrap;
+        m++;
+      }
+    }
+  }
+}
+
+void fillCircle(const Region& r, int cx, int cy, int radius, uint16_t color565) {
+  if (!r.buf || radius < 0) return;
+  int ya = cy - radius, yb = cy + radius;
+  if (ya < r.y0) ya = r.y0;
+  if (yb > r.y0 + r.h - 1) yb = r.y0 + r.h - 1;
+  for (int yy = ya; yy <= yb; ++yy) {
+    const int hw = discHalfWidth(radius, yy - cy);
+    hspan(r, cx - hw, cx + hw, yy, color565);
+  }
+}
+
+void circle(const Region& r, int cx, int cy, int radius, uint16_t color565) {
+  if (!r.buf || radius < 0) return;
+  int ya = cy - radius, yb = cy + radius;
+  if (ya < r.y0) ya = r.y0;
+  if (yb > r.y0 + r.h - 1) yb = r.y0 + r.h - 1;
+  // Pierścień: dysk r minus dysk r-1, po dwa spany na wiersz.
+  for (int yy = ya; yy <= yb; ++yy) {
+    const int outer = discHalfWidth(radius, yy - cy);
+    const int inner = discHalfWidth(radius - 1, yy - cy);
+    if (inner < 0) {
+      hspan(r, cx - outer, cx + outer, yy, color565);
+    } else {
+      hspan(r, cx - outer, cx - inner - 1, yy, color565);
+      hspan(r, cx + inner + 1, cx + outer, yy, color565);
+    }
+  }
+}
+
+void fillRoundRect(const Region& r, int x, int y, int w, int h, int radius, uint16_t color565) {
+  if (!r.buf) return;
+  radius = clampRadius(radius, w, h);
+  int ya = y, yb = y + h - 1;
+  if (ya < r.y0) ya = r.y0;
+  if (yb > r.y0 + r.h - 1) yb = r.y0 + r.h - 1;
+  for (int yy = ya; yy <= yb; ++yy) {
+    int left, right;
+    if (roundRectSpan(x, y, w, h, radius, yy, &left, &right)) hspan(r, left, right, yy, color565);
+  }
+}
+
+void roundRect(const Region& r, int x, int y, int w, int h, int radius, uint16_t color565) {
+  if (!r.buf) return;
+  radius = clampRadius(radius, w, h);
+  int ya = y, yb = y + h - 1;
+  if (ya < r.y0) ya = r.y0;
+  if (yb > r.y0 + r.h - 1) yb = r.y0 + r.h - 1;
+  // Obrys: prostokąt minus wnętrze o 1 px mniejsze z promieniem radius-1.
+  for (int yy = ya; yy <= yb; ++yy) {
+    int left, right, innerL, innerR;
+    if (!roundRectSpan(x, y, w, h, radius, yy, &left, &right)) continue;
+    if (!roundRectSpan(x + 1, y + 1, w - 2, h - 2, radius - 1 > 0 ? radius - 1 : 0, yy, &innerL, &innerR) ||
+        innerL > innerR) {
+      hspan(r, left, right, yy, color565);
+    } else {
+      hspan(r, left, innerL - 1, yy, color565);
+      hspan(r, innerR + 1, right, yy, color565);
+    }
+  }
+}
+
+void fillConvexPolygon(const Region& r, const int16_t* xy, int count, uint16_t color565) {
+  if (!r.buf || !xy || count < 3) return;
+
+  int pyMin = xy[1], pyMax = xy[1];
+  for (int i = 1; i < count; ++i) {
+    if (xy[i * 2 + 1] < pyMin) pyMin = xy[i * 2 + 1];
+    if (xy[i * 2 + 1] > pyMax) pyMax = xy[i * 2 + 1];
+  }
+  int ya = pyMin, yb = pyMax;
+  if (ya < r.y0) ya = r.y0;
+  if (yb > r.y0 + r.h - 1) yb = r.y0 + r.h - 1;
+
+  for (int yy = ya; yy <= yb; ++yy) {
+    // Próbkujemy w środku wiersza (yy + 0.5); x w 16.16.
+    const int64_t y2 = 2 * (int64_t)yy + 1;
+    int64_t xl = INT64_MAX, xr = INT64_MIN;
+    for (int i = 0, j = count - 1; i < count; j = i++) {
+      const int xi = xy[i * 2], yi = xy[i * 2 + 1];
+      const int xj = xy[j * 2], yj = xy[j * 2 + 1];
+      if (yi == yj) continue;
+      const int64_t lo = 2 * (int64_t)(yi < yj ? yi : yj);
+      const int64_t hi = 2 * (int64_t)(yi < yj ? yj : yi);
+      if (y2 < lo || y2 >= hi) continue;
+      const int64_t xf = (int64_t)xi * 65536 + (y2 - 2 * yi) * (xj - xi) * 65536 / (2 * (int64_t)(yj - yi));
+      if (xf < xl) xl = xf;
+      if (xf > xr) xr = xf;
+    }
+    if (xl > xr) continue;
+    // Piksel xx jest w środku, gdy xl <= xx + 0.5 < xr.
+    const int left = (int)((xl - 0x8000 + 0xFFFF) >> 16);
+    const int right = (int)((xr - 0x8000 + 0xFFFF) >> 16) - 1;
+    hspan(r, left, right, yy, color565);
+  }
+}
+
+Rect lineBounds(int x0, int y0, int x1, int y1) {
+  return makeRect(x0 < x1 ? x0 : x1, y0 < y1 ? y0 : y1, x0 < x1 ? x1 : x0, y0 < y1 ? y1 : y0);
+}
+
+Rect circleBounds(int cx, int cy, int radius) {
+  if (radius < 0) radius = 0;
+  return makeRect(cx - radius, cy - radius, cx + radius, cy + radius);
+}
+
+Rect rectBounds(int x, int y, int w, int h) {
+  return makeRect(x, y, x + (w > 0 ? w : 1) - 1, y + (h > 0 ? h : 1) - 1);
+}
+
+Rect polygonBounds(const int16_t* xy, int count) {
+  if (!xy || count <= 0) return makeRect(0, 0, -1, -1);
+  int x0 = xy[0], y0 = xy[1], x1 = xy[0], y1 = xy[1];
+  for (int i = 1; i < count; ++i) {
+    const int x = xy[i * 2], y = xy[i * 2 + 1];
+    if (x < x0) x0 = x;
+    if (x > x1) x1 = x;
+    if (y < y0) y0 = y;
+    if (y > y1) y1 = y;
+  }
+  return makeRect(x0, y0, x1, y1);
+}
+
+}  // namespace Raster
+
+void ShapeLayer::clear() {
+  for (auto& s : shapes_) s.active = false;
+}
+
+ShapeLayer::Shape& ShapeLayer::shape(int index) {
+  if (index < 0) index = 0;
+  if (index >= kMaxShapes) index = kMaxShapes - 1;
+  return shapes_[index];
+}
+
+ShapeLayer::Shape& ShapeLayer::setLine(int index, int x0, int y0, int x1, int y1, uint16_t color565) {
+  Shape& s = shape(index);
+  s.active = true;
+  s.kind = Kind::Line;
+  s.filled = false;
+  s.color = color565;
+  s.x0 = x0;
+  s.y0 = y0;
+  s.x1 = x1;
+  s.y1 = y1;
+  return s;
+}
+
+ShapeLayer::Shape& ShapeLayer::setCircle(int index, int cx, int cy, int radius, bool filled, uint16_t color565) {
+  Shape& s = shape(index);
+  s.active = true;
+  s.kind = Kind::Circle;
+  s.filled = filled;
+  s.color = color565;
+  s.x0 = cx;
+  s.y0 = cy;
+  s.radius = radius;
+  return s;
+}
+
+ShapeLayer::Shape& ShapeLayer::setRoundRect(int index, int x, int y, int w, int h, int radius, bool filled,
+                                            uint16_t color565) {
+  Shape& s = shape(index);
+  s.active = true;
+  s.kind = Kind::RoundRect;
+  s.filled = filled;
+  s.color = color565;
+  s.x0 = x;
+  s.y0 = y;
+  s.x1 = w;
+  s.y1 = h;
+  s.radius = radius;
+  return s;
+}
+
+ShapeLayer::Shape& ShapeLayer::setPolygon(int index, const int16_t* xy, int count, uint16_t color565) {
+  Shape& s = shape(index);
+  s.active = true;
+  s.kind = Kind::Polygon;
+  s.filled = true;
+  s.color = color565;
+  s.points = xy;
+  s.pointCount = count;
+  return s;
+}
+
+Rect ShapeLayer::shapeBounds(const Shape& s) {
+  switch (s.kind) {
+    case Kind::Line:
+      return Raster::lineBounds(s.x0, s.y0, s.x1, s.y1);
+    case Kind::Circle:
+      return Raster::circleBounds(s.x0, s.y0, s.radius);
+    case Kind::RoundRect:
+      return Raster::rectBounds(s.x0, s.y0, s.x1, s.y1);
+    case Kind::Polygon:
+      return Raster::polygonBounds(s.points, s.pointCount);
+  }
+  return Rect{0, 0, -1, -1};
+}
+
+void ShapeLayer::markDirty(DirtyRects& dirty) const {
+  for (const auto& s : shapes_) {
+    if (!s.active) continue;
+    const Rect b = shapeBounds(s);
+    if (b.x0 <= b.x1 && b.y0 <= b.y1) dirty.add(b.x0, b.y0, b.x1, b.y1);
+  }
+}
+
+void ShapeLayer::renderRegion(int x0, int y0, int w, int h, uint16_t* buf) const {
+  if (!buf || w <= 0 || h <= 0) return;
+  const Raster::Region r{x0, y0, w, h, buf};
+
+  for (const auto& s : shapes_) {
+    if (!s.active) continue;
+    const Rect b = shapeBounds(s);
+    if (b.x1 < x0 || b.x0 >= x0 + w || b.y1 < y0 || b.y0 >= y0 + h) continue;
+
+    switch (s.kind) {
+      case Kind::Line:
+        Raster::line(r, s.x0, s.y0, s.x1, s.y1, s.color);
+        break;
+      case Kind::Circle:
+        if (s.filled) {
+          Raster::fillCircle(r, s.x0, s.y0, s.radius, s.color);
+        } else {
+          Raster::circle(r, s.x0, s.y0, s.radius, s.color);
+        }
+        break;
+      case Kind::RoundRect:
+        if (s.filled) {
+          Raster::fillRoundRect(r, s.x0, s.y0, s.x1, s.y1, s.radius, s.color);
+        } else {
+          Raster::roundRect(r, s.x0, s.y0, s.x1, s.y1, s.radius, s.color);
+        }
+        break;
+      case Kind::Polygon:
+        Raster::fillConvexPolygon(r, s.points, s.pointCount, s.color);
+        break;
+    }
+  }
+}
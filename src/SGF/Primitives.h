@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "DirtyRects.h"
+
+// Vector primitives rasterized straight into a renderRegion tile buffer.
+// Every shape is evaluated per row (or per major-axis step for lines) from its
+// global parameters, so the pixels drawn are identical no matter how the
+// screen is split into tiles. Rows are clipped to the tile and written as
+// horizontal spans.
+namespace Raster {
+
+struct Region {
+  int x0;
+  int y0;
+  int w;
+  int h;
+  uint16_t* buf;
+};
+
+void hspan(const Region& r, int x0, int x1, int y, uint16_t color565);
+void line(const Region& r, int x0, int y0, int x1, int y1, uint16_t color565);
+void circle(const Region& r, int cx, int cy, int radius, uint16_t color565);
+void fillCircle(const Region& r, int cx, int cy, int radius, uint16_t color565);
+void roundRect(const Region& r, int x, int y, int w, int h, int radius, uint16_t color565);
+void fillRoundRect(const Region& r, int x, int y, int w, int h, int radius, uint16_t color565);
+// Convex polygon, points as x0, y0, x1, y1, ...; pixel centres inside are filled.
+void fillConvexPolygon(const Region& r, const int16_t* xy, int count, uint16_t color565);
+
+// Inclusive bounds for DirtyRects.
+Rect lineBounds(int x0, int y0, int x1, int y1);
+Rect circleBounds(int cx, int cy, int radius);
+Rect rectBounds(int x, int y, int w, int h);
+Rect polygonBounds(const int16_t* xy, int count);
+
+}  // namespace Raster
+
+// Fixed slots of vector shapes composed over a region buffer, used like
+// SpriteLayer: render with renderRegion() from the TileFlusher callback and
+// mark shapeBounds() dirty when a shape changes. Polygon points are referenced,
+// not copied.
+class ShapeLayer {
+public:
+  enum class Kind : uint8_t {
+    Line,
+    Circle,
+    RoundRect,
+    Polygon,
+  };
+
+  struct Shape {
+    bool active = false;
+    Kind kind = Kind::Line;
+    bool filled = false;
+    uint16_t color = 0xFFFF;
+    int x0 = 0;  // line start, circle centre, rect origin
+    int y0 = 0;
+    int x1 = 0;  // line end, rect size
+    int y1 = 0;
+    int radius = 0;  // circle / corner radius
+    const int16_t* points = nullptr;  // Polygon (always filled)
+    int pointCount = 0;
+  };
+
+  static constexpr int kMaxShapes = 16;
+
+  void clear();
+  Shape& shape(int index);
+
+  Shape& setLine(int index, int x0, int y0, int x1, int y1, uint16_t color565);
+  Shape& setCircle(int index, int cx, int cy, int radius, bool filled, uint16_t color565);
+  Shape& setRoundRect(int index, int x, int y, int w, int h, int radius, bool filled, uint16_t color565);
+  Shape& setPolygon(int index, const int16_t* xy, int count, uint16_t color565);
+
+  static Rect shapeBounds(const Shape& s);
+  void markDirty(DirtyRects& dirty) const;
+
+  void renderRegion(int x0, int y0, int w, int h, uint16_t* buf) const;
+
+private:
+  Shape shapes_[kMaxShapes];
+};
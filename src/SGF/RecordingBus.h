@@ -0,0 +1,124 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// PanelDriver bus that records the command stream instead of driving pins,
+// for checking a panel's init and window sequences on the host.
+//
+// Every byte sent with DC low opens a new Entry; the data bytes that follow
+// are counted and hashed (FNV-1a), and the first kMaxParams are kept.
+// streamHash() covers every byte with its DC state, so two runs can be
+// compared without storing the pixel data.
+class RecordingBus {
+public:
+  static constexpr int kMaxEntries = 96;
+  static constexpr int kMaxParams = 14;
+
+  struct Entry {
+    uint8_t cmd;
+    uint8_t paramCount;  // stored params, at most kMaxParams
+    uint8_t params[kMaxParams];
+    uint16_t selects;    // selects() when the command was sent
+    uint32_t dataBytes;
+    uint32_t dataHash;
+  };
+
+  RecordingBus(int cs = -1, int dc = -1) { (void)cs; (void)dc; }
+
+  bool begin(uint32_t hz) {
+    frequency = hz;
+    return true;
+  }
+  void setFrequency(uint32_t hz) { frequency = hz; }
+
+  void select(bool active) {
+    if (active && !selected) selectCount++;
+    selected = active;
+  }
+  void dataMode(bool data) { dc = data; }
+
+  uint32_t write(const void* data, size_t len) {
+    record(static_cast<const uint8_t*>(data), len);
+    transferCount++;
+    return 1;
+  }
+
+  uint32_t writeRepeat(const void* data, size_t len, size_t times, size_t tailLen = 0) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < times; i++) record(p, len);
+    if (tailLen) record(p, tailLen);
+    transferCount++;
+    return 1;
+  }
+
+  void clear() {
+    n = 0;
+    overflow = 0;
+    hash = kFnvBasis;
+    totalBytes = 0;
+    transferCount = 0;
+    selectCount = 0;
+    unselectedBytes = 0;
+  }
+
+  int count() const { return n; }
+  const Entry& operator[](int i) const { return entries[i]; }
+  // Index of the first entry with cmd at or after from, or -1.
+  int find(uint8_t cmd, int from = 0) const {
+    for (int i = from; i < n; i++) {
+      if (entries[i].cmd == cmd) return i;
+    }
+    return -1;
+  }
+
+  uint32_t streamHash() const { return hash; }
+  uint32_t bytes() const { return totalBytes; }
+  uint32_t transfers() const { return transferCount; }
+  uint32_t selects() const { return selectCount; }
+  uint32_t frequencyHz() const { return frequency; }
+  // Entries dropped because the log was full.
+  uint32_t dropped() const { return overflow; }
+  // Bytes written while CS was not asserted (always a driver bug).
+  uint32_t bytesOutsideSelect() const { return unselectedBytes; }
+
+private:
+  static constexpr uint32_t kFnvBasis = 2166136261u;
+  static constexpr uint32_t kFnvPrime = 16777619u;
+
+  void record(const uint8_t* p, size_t len) {
+    if (!selected) unselectedBytes += (uint32_t)len;
+    totalBytes += (uint32_t)len;
+    for (size_t i = 0; i < len; i++) {
+      hash = (hash ^ (uint32_t)(p[i] | (dc ? 0x100u : 0u))) * kFnvPrime;
+      if (!dc) {
+        if (n >= kMaxEntries) {
+          overflow++;
+          continue;
+        }
+        Entry& e = entries[n++];
+        e.cmd = p[i];
+        e.paramCount = 0;
+        e.selects = (uint16_t)selectCount;
+        e.dataBytes = 0;
+        e.dataHash = kFnvBasis;
+      } else if (n > 0 && !overflow) {
+        Entry& e = entries[n - 1];
+        if (e.paramCount < kMaxParams && e.dataBytes == e.paramCount) e.params[e.paramCount++] = p[i];
+        e.dataBytes++;
+        e.dataHash = (e.dataHash ^ p[i]) * kFnvPrime;
+      }
+    }
+  }
+
+  Entry entries[kMaxEntries];
+  int n = 0;
+  uint32_t overflow = 0;
+  uint32_t hash = kFnvBasis;
+  uint32_t totalBytes = 0;
+  uint32_t transferCount = 0;
+  uint32_t selectCount = 0;
+  uint32_t unselectedBytes = 0;
+  uint32_t frequency = 0;
+  bool selected = false;
+  bool dc = true;
+};
@@ -7,7 +7,10 @@ RectFlashAnim::RectFlashAnim(RectFlashAnimSlot *slots, int slotCount, uint16_t w
       warmWhiteColor_(warmWhiteColor) {}
 
 void RectFlashAnim::clear() {
-  for (int i = 0; i < slotCount_; i++) slots_[i].active = false;
+  for (int i = 0; i < slotCount_; i++) {
+    cancelPhase(slots_[i]);
+    slots_[i].active = false;
+  }
 }
 
 void RectFlashAnim::spawn(int x0, int y0, int x1, int y1, uint32_t durationUs, uint16_t baseColor, uint16_t lightColor) {
@@ -21,6 +24,7 @@ void RectFlashAnim::spawn(int x0, int y0, int x1, int y1, uint32_t durationUs, u
   if (slot < 0) slot = 0;
 
   RectFlashAnimSlot &f = slots_[slot];
+  cancelPhase(f);
   f.active = true;
   f.remUs = durationUs;
   f.totalUs = durationUs;
@@ -30,6 +34,37 @@ void RectFlashAnim::spawn(int x0, int y0, int x1, int y1, uint32_t durationUs, u
   f.y1 = y1;
   f.baseColor = baseColor;
   f.lightColor = lightColor;
+  f.phase = phaseOf(f);
+
+  if (timers_) {
+    timerDirty_->add(x0 - 1, y0 - 1, x1 + 1, y1 + 1);
+    schedulePhase(slot);
+  }
+}
+
+void RectFlashAnim::spawn(int x0, int y0, int x1, int y1, uint32_t durationUs, uint16_t baseColor, uint16_t lightColor,
+                          DirtyRects &dirty) {
+  spawn(x0, y0, x1, y1, durationUs, baseColor, lightColor);
+  dirty.add(x0 - 1, y0 - 1, x1 + 1, y1 + 1);
+}
+
+uint8_t RectFlashAnim::phaseOf(const RectFlashAnimSlot &f) {
+  if (f.totalUs == 0) return 3;
+  uint64_t rem4 = (uint64_t)f.remUs * 4u;
+  uint64_t tot = (uint64_t)f.totalUs;
+  if (rem4 > tot * 3u) return 0;
+  if (rem4 > tot * 2u) return 1;
+  if (rem4 > tot) return 2;
+  return 3;
+}
+
+uint16_t RectFlashAnim::phaseColor(const RectFlashAnimSlot &f) const {
+  switch (f.phase) {
+    case 0: return whiteColor_;
+    case 1: return warmWhiteColor_;
+    case 2: return f.lightColor;
+    default: return f.baseColor;
+  }
 }
 
 uint16_t RectFlashAnim::colorAt(int x, int y) const {
@@ -37,18 +72,35 @@ uint16_t RectFlashAnim::colorAt(int x, int y) const {
     const RectFlashAnimSlot &f = slots_[i];
     if (!f.active) continue;
     if (x < f.x0 || x > f.x1 || y < f.y0 || y > f.y1) continue;
-
-    if (f.totalUs == 0) return f.baseColor;
-    uint64_t rem4 = (uint64_t)f.remUs * 4u;
-    uint64_t tot = (uint64_t)f.totalUs;
-    if (rem4 > tot * 3u) return whiteColor_;
-    if (rem4 > tot * 2u) return warmWhiteColor_;
-    if (rem4 > tot) return f.lightColor;
-    return f.baseColor;
+    return phaseColor(f);
   }
   return 0;
 }
 
+void RectFlashAnim::renderRegion(int x0, int y0, int w, int h, uint16_t *buf) const {
+  if (!buf || w <= 0 || h <= 0) return;
+  const int x1 = x0 + w - 1;
+  const int y1 = y0 + h - 1;
+
+  // Od ostatniego slotu, żeby niższe nadpisywały wyższe jak w colorAt().
+  for (int i = slotCount_ - 1; i >= 0; i--) {
+    const RectFlashAnimSlot &f = slots_[i];
+    if (!f.active) continue;
+    const int rx0 = f.x0 > x0 ? f.x0 : x0;
+    const int ry0 = f.y0 > y0 ? f.y0 : y0;
+    const int rx1 = f.x1 < x1 ? f.x1 : x1;
+    const int ry1 = f.y1 < y1 ? f.y1 : y1;
+    if (rx1 < rx0 || ry1 < ry0) continue;
+
+    const uint16_t c = phaseColor(f);
+    const int span = rx1 - rx0 + 1;
+    for (int yy = ry0; yy <= ry1; yy++) {
+      uint16_t *row = buf + (yy - y0) * w + (rx0 - x0);
+      for (int xx = 0; xx < span; xx++) row[xx] = c;
+    }
+  }
+}
+
 void RectFlashAnim::markDirty(DirtyRects &dirty) const {
   for (int i = 0; i < slotCount_; i++) {
     if (!slots_[i].active) continue;
@@ -57,7 +109,7 @@ void RectFlashAnim::markDirty(DirtyRects &dirty) const {
 }
 
 void RectFlashAnim::advance(uint32_t dtUs, DirtyRects &dirty) {
-  if (dtUs == 0) return;
+  if (dtUs == 0 || timers_) return;
 
   for (int i = 0; i < slotCount_; i++) {
     RectFlashAnimSlot &f = slots_[i];
@@ -65,6 +117,11 @@ void RectFlashAnim::advance(uint32_t dtUs, DirtyRects &dirty) {
 
     if (f.remUs > dtUs) {
       f.remUs -= dtUs;
+      uint8_t phase = phaseOf(f);
+      if (phase != f.phase) {
+        f.phase = phase;
+        dirty.add(f.x0 - 1, f.y0 - 1, f.x1 + 1, f.y1 + 1);
+      }
       continue;
     }
 
@@ -73,3 +130,47 @@ void RectFlashAnim::advance(uint32_t dtUs, DirtyRects &dirty) {
     f.active = false;
   }
 }
+
+void RectFlashAnim::attachTimers(TimerWheel *timers, DirtyRects *dirty) {
+  for (int i = 0; i < slotCount_; i++) cancelPhase(slots_[i]);
+  timers_ = (timers && dirty) ? timers : nullptr;
+  timerDirty_ = timers_ ? dirty : nullptr;
+  for (int i = 0; i < slotCount_; i++) {
+    slots_[i].timer = TimerWheel::kInvalid;
+    if (timers_ && slots_[i].active) schedulePhase(i);
+  }
+}
+
+uint32_t RectFlashAnim::nextBoundaryUs(const RectFlashAnimSlot &f) {
+  // remUs, przy którym phaseOf() przechodzi do następnej fazy (0 = koniec).
+  if (f.phase >= 3 || f.totalUs == 0) return 0;
+  return (uint32_t)(((uint64_t)f.totalUs * (uint32_t)(3 - f.phase)) / 4u);
+}
+
+void RectFlashAnim::schedulePhase(int slot) {
+  RectFlashAnimSlot &f = slots_[slot];
+  const uint32_t boundary = nextBoundaryUs(f);
+  const uint32_t delay = f.remUs > boundary ? f.remUs - boundary : 0;
+  f.timer = timers_->schedule(delay, onPhaseTimer, this, (uint32_t)slot);
+}
+
+void RectFlashAnim::cancelPhase(RectFlashAnimSlot &f) {
+  if (timers_ && f.timer != TimerWheel::kInvalid) timers_->cancel(f.timer);
+  f.timer = TimerWheel::kInvalid;
+}
+
+void RectFlashAnim::onPhaseTimer(void *user, uint32_t slot) {
+  RectFlashAnim &self = *static_cast<RectFlashAnim *>(user);
+  RectFlashAnimSlot &f = self.slots_[slot];
+  f.timer = TimerWheel::kInvalid;
+  if (!f.active) return;
+
+  self.timerDirty_->add(f.x0 - 1, f.y0 - 1, f.x1 + 1, f.y1 + 1);
+  f.remUs = nextBoundaryUs(f);
+  if (f.remUs == 0) {
+    f.active = false;
+    return;
+  }
+  f.phase = phaseOf(f);
+  self.schedulePhase((int)slot);
+}
@@ -2,6 +2,7 @@
 
 #include <Arduino.h>
 #include "DirtyRects.h"
+#include "TimerWheel.h"
 
 struct RectFlashAnimSlot {
   bool active;
@@ -10,6 +11,8 @@ struct RectFlashAnimSlot {
   int x0, y0, x1, y1;
   uint16_t baseColor;
   uint16_t lightColor;
+  uint8_t phase;  // 0 = white, 1 = warm white, 2 = light, 3 = base
+  TimerWheel::Handle timer;
 };
 
 class RectFlashAnim {
@@ -18,13 +21,37 @@ public:
 
   void clear();
   void spawn(int x0, int y0, int x1, int y1, uint32_t durationUs, uint16_t baseColor, uint16_t lightColor);
+  // Same, and marks the new flash dirty.
+  void spawn(int x0, int y0, int x1, int y1, uint32_t durationUs, uint16_t baseColor, uint16_t lightColor,
+             DirtyRects &dirty);
   uint16_t colorAt(int x, int y) const;
+  // Fills the clipped spans of all active flashes into buf (w x h at x0, y0);
+  // pixels outside any flash are left untouched. Lower slots win on overlap.
+  void renderRegion(int x0, int y0, int w, int h, uint16_t *buf) const;
   void markDirty(DirtyRects &dirty) const;
+  // Adds dirty rects only when a flash changes colour or expires; call
+  // markDirty() once after spawn() instead of every frame.
   void advance(uint32_t dtUs, DirtyRects &dirty);
 
+  // Timer-driven mode: every flash gets a timer for its next phase boundary,
+  // phase changes and expiry go straight into dirty, spawn() marks new flashes
+  // and advance() becomes a no-op. remUs is only updated at phase boundaries.
+  // Pass nullptr to return to polling.
+  void attachTimers(TimerWheel *timers, DirtyRects *dirty);
+
 private:
+  static void onPhaseTimer(void *user, uint32_t slot);
+  static uint32_t nextBoundaryUs(const RectFlashAnimSlot &f);
+  void schedulePhase(int slot);
+  void cancelPhase(RectFlashAnimSlot &f);
+
+  static uint8_t phaseOf(const RectFlashAnimSlot &f);
+  uint16_t phaseColor(const RectFlashAnimSlot &f) const;
+
   RectFlashAnimSlot *slots_;
   int slotCount_;
   uint16_t whiteColor_;
   uint16_t warmWhiteColor_;
+  TimerWheel *timers_ = nullptr;
+  DirtyRects *timerDirty_ = nullptr;
 };
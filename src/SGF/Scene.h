@@ -1,5 +1,9 @@
 #pragma once
 
+#include <stdint.h>
+
+#include "DirtyRects.h"
+
 class Scene {
 public:
   virtual ~Scene() = default;
@@ -8,6 +12,19 @@ public:
   virtual void onExit() {}
   virtual void onPhysics(float delta) = 0;
   virtual void onProcess(float delta) = 0;
+
+  // SceneStack hooks: called when an overlay freezes / unfreezes this scene.
+  virtual void onPause() {}
+  virtual void onResume() {}
+  // Pixels of this scene for SceneStack::renderRegion(); overlays only need to
+  // draw inside their rect.
+  virtual void renderRegion(int x0, int y0, int w, int h, uint16_t* buf) {
+    (void)x0;
+    (void)y0;
+    (void)w;
+    (void)h;
+    (void)buf;
+  }
 };
 
 class SceneSwitcher {
@@ -46,3 +63,123 @@ public:
 private:
   Scene* currentScene = nullptr;
 };
+
+// Bounded stack of a base scene plus overlays (pause menu, dialog, ...).
+// Each overlay declares its screen rect; push() and pop() mark only that rect
+// dirty, and renderRegion() composes the stack bottom-up, skipping overlays
+// that miss the region and scenes hidden under an opaque overlay. A frozen
+// scene gets no onPhysics/onProcess calls but still renders.
+class SceneStack {
+public:
+  static constexpr int kMaxDepth = 4;
+
+  void setInitial(Scene& scene) {
+    depth = 1;
+    entries[0] = Entry{&scene, Rect{0, 0, 0, 0}, false, false};
+    scene.onEnter();
+  }
+
+  // Replaces the whole stack with scene (a regular scene switch).
+  void switchTo(Scene& scene) {
+    if (depth == 1 && entries[0].scene == &scene) {
+      return;
+    }
+    while (depth > 0) {
+      entries[--depth].scene->onExit();
+    }
+    setInitial(scene);
+  }
+
+  // freezeBelow stops physics and processing of every scene under the
+  // overlay; opaque lets renderRegion() skip them inside the overlay rect.
+  bool push(Scene& overlay, int x0, int y0, int x1, int y1, DirtyRects& dirty,
+            bool freezeBelow = true, bool opaque = true) {
+    if (depth == 0 || depth >= kMaxDepth) {
+      return false;
+    }
+    if (freezeBelow) {
+      for (int i = depth - 1; i >= 0 && !frozen(i); i--) {
+        entries[i].scene->onPause();
+      }
+    }
+    entries[depth++] = Entry{&overlay, Rect{(int16_t)x0, (int16_t)y0, (int16_t)x1, (int16_t)y1},
+                             freezeBelow, opaque};
+    overlay.onEnter();
+    dirty.add(x0, y0, x1, y1);
+    return true;
+  }
+
+  bool pop(DirtyRects& dirty) {
+    if (depth <= 1) {
+      return false;
+    }
+    const Entry top = entries[--depth];
+    top.scene->onExit();
+    dirty.add(top.rect.x0, top.rect.y0, top.rect.x1, top.rect.y1);
+    if (top.freezeBelow) {
+      for (int i = depth - 1; i >= 0 && !frozen(i); i--) {
+        entries[i].scene->onResume();
+      }
+    }
+    return true;
+  }
+
+  void onPhysics(float delta) {
+    for (int i = depth - 1; i >= 0 && !frozen(i); i--) {
+      entries[i].scene->onPhysics(delta);
+    }
+  }
+
+  void onProcess(float delta) {
+    for (int i = depth - 1; i >= 0 && !frozen(i); i--) {
+      entries[i].scene->onProcess(delta);
+    }
+  }
+
+  void renderRegion(int x0, int y0, int w, int h, uint16_t* buf) {
+    const int x1 = x0 + w - 1;
+    const int y1 = y0 + h - 1;
+    // Najwyższa nieprzezroczysta nakładka zakrywająca cały region ucina dół stosu.
+    int first = 0;
+    for (int i = depth - 1; i >= 1; i--) {
+      const Entry& e = entries[i];
+      if (e.opaque && e.rect.x0 <= x0 && e.rect.y0 <= y0 && e.rect.x1 >= x1 && e.rect.y1 >= y1) {
+        first = i;
+        break;
+      }
+    }
+    for (int i = first; i < depth; i++) {
+      const Entry& e = entries[i];
+      if (i > 0 && (e.rect.x1 < x0 || e.rect.x0 > x1 || e.rect.y1 < y0 || e.rect.y0 > y1)) {
+        continue;
+      }
+      e.scene->renderRegion(x0, y0, w, h, buf);
+    }
+  }
+
+  Scene* top() const { return depth ? entries[depth - 1].scene : nullptr; }
+  Scene* base() const { return depth ? entries[0].scene : nullptr; }
+  int size() const { return depth; }
+  bool hasOverlay() const { return depth > 1; }
+
+private:
+  struct Entry {
+    Scene* scene;
+    Rect rect;  // overlay rect (inclusive), unused for the base scene
+    bool freezeBelow;
+    bool opaque;
+  };
+
+  // True when an overlay above entry i freezes it.
+  bool frozen(int i) const {
+    for (int j = i + 1; j < depth; j++) {
+      if (entries[j].freezeBelow) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  Entry entries[kMaxDepth];
+  int depth = 0;
+};
@@ -0,0 +1,44 @@
+#include "SpiBus.h"
+
+bool ZephyrSpiBus::begin(uint32_t hz) {
+  pinMode(PIN_CS, OUTPUT);
+  pinMode(PIN_DC, OUTPUT);
+  digitalWrite(PIN_CS, HIGH);
+  digitalWrite(PIN_DC, HIGH);
+
+  if (!spiDev) spiDev = DEVICE_DT_GET(DT_NODELABEL(SGF_DISPLAY_SPI_NODE));
+  if (!spiDev || !device_is_ready(spiDev)) return false;
+
+  spiCfg.frequency = hz;
+  spiCfg.operation = SPI_OP_MODE_MASTER | SPI_WORD_SET(8) | SPI_TRANSFER_MSB;
+  spiCfg.slave = 0;
+  spiCfg.cs = spi_cs_control{};
+  return true;
+}
+
+uint32_t ZephyrSpiBus::write(const void* data, size_t len) {
+  spi_buf b{ .buf = (void*)data, .len = len };
+  spi_buf_set s{ .buffers = &b, .count = 1 };
+  (void)spi_write(spiDev, &spiCfg, &s);
+  return 1;
+}
+
+uint32_t ZephyrSpiBus::writeRepeat(const void* data, size_t len, size_t times, size_t tailLen) {
+  // Ten sam bufor kilka razy w jednym spi_write (do kMaxBufs), reszta na końcu.
+  spi_buf bufs[kMaxBufs];
+  uint32_t transfers = 0;
+  size_t left = times + (tailLen ? 1 : 0);
+  while (left > 0) {
+    size_t nb = 0;
+    while (left > 0 && nb < kMaxBufs) {
+      bufs[nb].buf = (void*)data;
+      bufs[nb].len = (left == 1 && tailLen) ? tailLen : len;
+      nb++;
+      left--;
+    }
+    spi_buf_set s{ .buffers = bufs, .count = nb };
+    (void)spi_write(spiDev, &spiCfg, &s);
+    transfers++;
+  }
+  return transfers;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <Arduino.h>
+
+extern "C" {
+  #include <zephyr/device.h>
+  #include <zephyr/drivers/spi.h>
+}
+
+// Devicetree node of the display SPI controller (UNO Q: spi2).
+#ifndef SGF_DISPLAY_SPI_NODE
+#define SGF_DISPLAY_SPI_NODE spi2
+#endif
+
+// Display bus for PanelDriver: Zephyr SPI controller plus GPIO chip select
+// and data/command lines.
+//
+// Bus interface used by PanelDriver (RecordingBus implements the same one):
+//   bool begin(uint32_t hz)       configure pins and the controller
+//   void setFrequency(uint32_t hz)
+//   void select(bool active)      CS asserted while active
+//   void dataMode(bool data)      DC high for data, low for commands
+//   uint32_t write(data, len)     one transfer; returns transfers issued
+//   uint32_t writeRepeat(data, len, times, tailLen)
+//                                 data[0..len) times, then data[0..tailLen),
+//                                 as few transfers as the bus allows
+class ZephyrSpiBus {
+public:
+  static constexpr size_t kMaxBufs = 8;  // spi_bufs per spi_write
+
+  ZephyrSpiBus(int cs, int dc) : PIN_CS(cs), PIN_DC(dc) {}
+
+  // Overrides the SGF_DISPLAY_SPI_NODE controller; call before begin().
+  void setDevice(const struct device* dev) { spiDev = dev; }
+
+  bool begin(uint32_t hz);
+  void setFrequency(uint32_t hz) { spiCfg.frequency = hz; }
+
+  void select(bool active) { digitalWrite(PIN_CS, active ? LOW : HIGH); }
+  void dataMode(bool data) { digitalWrite(PIN_DC, data ? HIGH : LOW); }
+
+  uint32_t write(const void* data, size_t len);
+  uint32_t writeRepeat(const void* data, size_t len, size_t times, size_t tailLen = 0);
+
+private:
+  int PIN_CS, PIN_DC;
+  const struct device* spiDev = nullptr;
+  struct spi_config spiCfg{};
+};
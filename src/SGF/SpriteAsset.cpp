@@ -0,0 +1,53 @@
+#include "SpriteAsset.h"
+
+#include <string.h>
+
+bool SpriteAsset::applyTo(SpriteLayer::Sprite& s, const uint16_t* pixels) const {
+  const uint16_t* src = pixels ? pixels : (format == Format::Rgb565 ? pixels565 : nullptr);
+  if (!src || w == 0 || h == 0) return false;
+
+  s.w = w;
+  s.h = h;
+  s.pixels565 = src;
+  s.transparent = transparent;
+  s.anchorX = w > 1 ? (float)anchorX / (float)(w - 1) : 0.0f;
+  s.anchorY = h > 1 ? (float)anchorY / (float)(h - 1) : 0.0f;
+  s.blend = alphaMask ? blend : SpriteLayer::Blend::Key;
+  s.alphaMask = alphaMask;
+  // Odcinki pasują tylko do oryginalnych pikseli klatki 0.
+  s.opaqueSpans = (src == pixels565 && frames <= 1) ? opaqueSpans : nullptr;
+  return true;
+}
+
+void SpriteAsset::decode(uint16_t* out) const {
+  if (!out) return;
+  const size_t n = framePixels() * (frames ? frames : 1);
+
+  switch (format) {
+    case Format::Rgb565:
+      if (pixels565) memcpy(out, pixels565, n * 2);
+      break;
+
+    case Format::Indexed8:
+      for (size_t i = 0; i < n; i++) out[i] = palette565[indices[i]];
+      break;
+
+    case Format::Indexed4: {
+      const int rowBytes = (w + 1) / 2;
+      const int rowsTotal = h * (frames ? frames : 1);
+      for (int y = 0; y < rowsTotal; y++) {
+        const uint8_t* row = indices + y * rowBytes;
+        uint16_t* dst = out + (size_t)y * w;
+        for (int x = 0; x < w; x++) {
+          const uint8_t b = row[x >> 1];
+          dst[x] = palette565[(x & 1) ? (b & 0x0F) : (b >> 4)];
+        }
+      }
+      break;
+    }
+  }
+}
+
+SpriteSheet SpriteAsset::sheet(const uint16_t* pixels) const {
+  return SpriteSheet{pixels ? pixels : pixels565, alphaMask, w, h, frames ? frames : 1};
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "AnimatedSprite.h"
+#include "Sprites.h"
+
+// Sprite data as emitted by the host asset compiler (tools/sgfasset).
+//
+// Pixel formats:
+//   Rgb565    pixels565, w * h * frames, frames stacked back to back
+//             (SpriteSheet layout); drawn directly
+//   Indexed8  indices, one byte per pixel, into palette565
+//   Indexed4  indices, two pixels per byte (high nibble first, rows padded
+//             to bytes), into palette565
+// Indexed data is the small storage format: decode() expands it into an
+// RGB565 buffer (e.g. at scene load or in an asset cache) before drawing.
+//
+// opaqueSpans (single-frame Rgb565 with a transparent key only):
+//   [h + 1 row offsets][per row: (x, len) pairs], all uint16_t, offsets
+//   counted from the start of the array; row r's pairs are
+//   [spans[r], spans[r + 1]).
+//
+// alphaMask follows the Blend::Mask1 / Blend::Mask4 layout of SpriteLayer;
+// collisionMask is 1 bit per pixel in the Mask1 layout, for maskHit().
+struct SpriteAsset {
+  enum class Format : uint8_t {
+    Rgb565,
+    Indexed8,
+    Indexed4,
+  };
+
+  Format format;
+  uint16_t w;
+  uint16_t h;
+  uint16_t frames;
+  int16_t anchorX;  // pixels from the top-left corner
+  int16_t anchorY;
+  bool keyed;             // transparent is meaningful
+  uint16_t transparent;   // RGB565 key (also the decoded colour of the key index)
+  const uint16_t* pixels565;
+  const uint8_t* indices;
+  const uint16_t* palette565;
+  uint16_t paletteSize;
+  const uint16_t* opaqueSpans;
+  SpriteLayer::Blend blend;  // Key, Mask1 or Mask4
+  const uint8_t* alphaMask;
+  const uint8_t* collisionMask;
+
+  size_t framePixels() const { return (size_t)w * h; }
+  bool drawable() const { return format == Format::Rgb565 && pixels565; }
+
+  // Fills size, pixels, key, anchor, blend and masks of s (frame 0) without
+  // touching position or active. pixels565 overrides the asset pixels, e.g.
+  // with a decode() buffer for indexed assets. Returns false when there is
+  // nothing drawable.
+  bool applyTo(SpriteLayer::Sprite& s, const uint16_t* pixels565 = nullptr) const;
+
+  // Expands frames * w * h pixels into out (Rgb565 assets are copied).
+  void decode(uint16_t* out) const;
+
+  // Sheet over the asset pixels (or a decode() buffer) for AnimatedSprite.
+  SpriteSheet sheet(const uint16_t* pixels565 = nullptr) const;
+};
@@ -31,6 +31,15 @@ public:
     boundSpritePtr->setPosition(pos.x, pos.y);
   }
 
+  // Same as bindSprite(layer.sprite(slot)); an attached character also records
+  // the slot in its EntityStore so EntityStore::syncSprites() moves the sprite.
+  void bindSprite(SpriteLayer& layer, int slot) {
+    bindSprite(layer.sprite(slot));
+    if (EntityStore* entities = entityStore()) {
+      entities->bindSprite(entity(), slot);
+    }
+  }
+
 protected:
   virtual void configureBoundSprite(SpriteLayer::Sprite& sprite) = 0;
 
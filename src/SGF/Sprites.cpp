@@ -1,5 +1,9 @@
 #include "Sprites.h"
 
+#include <string.h>
+
+#include "Color565.h"
+
 namespace {
 
 bool doublesX(SpriteLayer::Scale scale) {
@@ -37,6 +41,83 @@ void spriteTopLeft(const SpriteLayer::Sprite& s, int* x, int* y) {
   }
 }
 
+uint8_t maskAlpha(const SpriteLayer::Sprite& s, int srcX, int srcY) {
+  if (s.blend == SpriteLayer::Blend::Mask1) {
+    const uint8_t* row = s.alphaMask + srcY * ((s.w + 7) / 8);
+    return (row[srcX >> 3] & (0x80u >> (srcX & 7))) ? 32 : 0;
+  }
+  const uint8_t* row = s.alphaMask + srcY * ((s.w + 1) / 2);
+  uint8_t a4 = (srcX & 1) ? (row[srcX >> 1] & 0x0F) : (row[srcX >> 1] >> 4);
+  return a4 >= 15 ? 32 : (uint8_t)(a4 * 2);
+}
+
+// One destination row of a blended sprite; dst[0] is screen x dstX0.
+void blendRow(const SpriteLayer::Sprite& s, int srcY, int sx0, int rx0, int rx1, uint16_t* dst, int dstX0) {
+  const uint16_t* src = s.pixels565 + srcY * s.w;
+  const bool dx = doublesX(s.scale);
+  auto srcAt = [&](int xx) { return dx ? ((xx - sx0) >> 1) : (xx - sx0); };
+
+  switch (s.blend) {
+    case SpriteLayer::Blend::Additive: {
+      // Dwa piksele na słowo 32-bit.
+      int xx = rx0;
+      for (; xx + 1 <= rx1; xx += 2) {
+        uint16_t c0 = src[srcAt(xx)];
+        uint16_t c1 = src[srcAt(xx + 1)];
+        uint32_t sum = Color565::addSat2(((uint32_t)c1 << 16) | c0,
+                                          ((uint32_t)dst[xx + 1 - dstX0] << 16) | dst[xx - dstX0]);
+        if (c0 != s.transparent) dst[xx - dstX0] = (uint16_t)sum;
+        if (c1 != s.transparent) dst[xx + 1 - dstX0] = (uint16_t)(sum >> 16);
+      }
+      if (xx <= rx1) {
+        uint16_t c = src[srcAt(xx)];
+        if (c != s.transparent) dst[xx - dstX0] = Color565::addSat(dst[xx - dstX0], c);
+      }
+      break;
+    }
+
+    case SpriteLayer::Blend::Alpha: {
+      const uint8_t a = s.alpha >= 31 ? 32 : s.alpha;
+      if (a == 0) break;
+      for (int xx = rx0; xx <= rx1; ++xx) {
+        uint16_t c = src[srcAt(xx)];
+        if (c != s.transparent) dst[xx - dstX0] = Color565::blend(dst[xx - dstX0], c, a);
+      }
+      break;
+    }
+
+    case SpriteLayer::Blend::Mask1:
+    case SpriteLayer::Blend::Mask4:
+      if (!s.alphaMask) break;
+      for (int xx = rx0; xx <= rx1; ++xx) {
+        int sx = srcAt(xx);
+        uint16_t c = src[sx];
+        if (c == s.transparent) continue;
+        uint8_t a = maskAlpha(s, sx, srcY);
+        if (a == 32) {
+          dst[xx - dstX0] = c;
+        } else if (a != 0) {
+          dst[xx - dstX0] = Color565::blend(dst[xx - dstX0], c, a);
+        }
+      }
+      break;
+
+    case SpriteLayer::Blend::Multiply:
+      for (int xx = rx0; xx <= rx1; ++xx) {
+        uint16_t c = src[srcAt(xx)];
+        if (c != s.transparent) dst[xx - dstX0] = Color565::multiply(dst[xx - dstX0], c);
+      }
+      break;
+
+    case SpriteLayer::Blend::Key:
+      for (int xx = rx0; xx <= rx1; ++xx) {
+        uint16_t c = src[srcAt(xx)];
+        if (c != s.transparent) dst[xx - dstX0] = c;
+      }
+      break;
+  }
+}
+
 }  // namespace
 
 SpriteLayer::SpriteLayer() = default;
@@ -141,6 +222,27 @@ void SpriteLayer::renderRegion(int x0, int y0, int w, int h, uint16_t* buf) cons
     for (int yy = ry0; yy <= ry1; ++yy) {
       int srcY = yy - sy0;
       if (doublesY(s.scale)) srcY /= 2;
+      if (s.blend != Blend::Key) {
+        blendRow(s, srcY, sx0, rx0, rx1, buf + (yy - y0) * w, x0);
+        continue;
+      }
+      if (s.opaqueSpans && !doublesX(s.scale)) {
+        // Gotowe odcinki nieprzezroczyste: kopiowanie bez porównań z kluczem.
+        const uint16_t* run = s.opaqueSpans + s.opaqueSpans[srcY];
+        const uint16_t* end = s.opaqueSpans + s.opaqueSpans[srcY + 1];
+        const uint16_t* src = s.pixels565 + srcY * s.w;
+        uint16_t* dst = buf + (yy - y0) * w - x0;
+        for (; run < end; run += 2) {
+          int a = sx0 + run[0];
+          int b = a + run[1] - 1;
+          if (b < rx0) continue;
+          if (a > rx1) break;
+          if (a < rx0) a = rx0;
+          if (b > rx1) b = rx1;
+          memcpy(dst + a, src + (a - sx0), (size_t)(b - a + 1) * 2);
+        }
+        continue;
+      }
       for (int xx = rx0; xx <= rx1; ++xx) {
         int srcX = xx - sx0;
         if (doublesX(s.scale)) srcX /= 2;
@@ -159,3 +261,156 @@ void SpriteLayer::renderRegion(int x0, int y0, int w, int h, uint16_t* buf) cons
   for (const auto& m : missiles_) blitMissile(m);
   for (const auto& s : sprites_) blitSprite(s);
 }
+
+void SpriteLayer::setSaveUnderArena(uint16_t* arena, size_t pixels, int screenW, int screenH,
+                                    BackgroundFn background) {
+  saveArena_ = (arena && pixels) ? arena : nullptr;
+  saveArenaPixels_ = saveArena_ ? pixels : 0;
+  saveScreenW_ = screenW;
+  saveScreenH_ = screenH;
+  background_ = std::move(background);
+  for (int i = 0; i < kMaxSprites; i++) freeSaveUnder(i);
+}
+
+void SpriteLayer::setSaveUnder(int index, int margin) {
+  if (index < 0 || index >= kMaxSprites) return;
+  if (margin < 0) freeSaveUnder(index);
+  saveUnder_[index].margin = (int16_t)(margin < 0 ? -1 : margin);
+}
+
+void SpriteLayer::invalidateBackground(int x0, int y0, int x1, int y1) {
+  for (int i = 0; i < kMaxSprites; i++) {
+    const SaveUnder& e = saveUnder_[i];
+    if (!e.pixels || x1 < e.x0 || x0 > e.x1 || y1 < e.y0 || y0 > e.y1) continue;
+    freeSaveUnder(i);
+    saveStats_.invalidations++;
+  }
+}
+
+void SpriteLayer::invalidateBackground() {
+  for (int i = 0; i < kMaxSprites; i++) {
+    if (!saveUnder_[i].pixels) continue;
+    freeSaveUnder(i);
+    saveStats_.invalidations++;
+  }
+}
+
+void SpriteLayer::renderBackground(int x0, int y0, int w, int h, uint16_t* buf) {
+  if (!buf || w <= 0 || h <= 0 || !background_) return;
+  const int x1 = x0 + w - 1;
+  const int y1 = y0 + h - 1;
+
+  int hit = -1;
+  for (int i = 0; i < kMaxSprites && hit < 0; i++) {
+    const SaveUnder& e = saveUnder_[i];
+    if (e.pixels && x0 >= e.x0 && y0 >= e.y0 && x1 <= e.x1 && y1 <= e.y1) hit = i;
+  }
+
+  if (hit >= 0) {
+    saveStats_.hits++;
+    saveStats_.pixelsRestored += (uint32_t)(w * h);
+  } else if (saveArena_) {
+    // Nowy prostokąt tylko dla sprite'a, który wyszedł ze swojego (albo
+    // jeszcze go nie ma) i tylko gdy region w nim leży; inaczej render wprost.
+    for (int i = 0; i < kMaxSprites && hit < 0; i++) {
+      SaveUnder& e = saveUnder_[i];
+      const Sprite& s = sprites_[i];
+      if (e.margin < 0 || !s.active || s.w <= 0 || s.h <= 0) continue;
+
+      int bx0 = 0;
+      int by0 = 0;
+      int bx1 = 0;
+      int by1 = 0;
+      spriteBounds(s, &bx0, &by0, &bx1, &by1);
+      bx0 = bx0 < 0 ? 0 : bx0;
+      by0 = by0 < 0 ? 0 : by0;
+      bx1 = bx1 >= saveScreenW_ ? saveScreenW_ - 1 : bx1;
+      by1 = by1 >= saveScreenH_ ? saveScreenH_ - 1 : by1;
+      if (bx0 > bx1 || by0 > by1) continue;
+      if (e.pixels && bx0 >= e.x0 && by0 >= e.y0 && bx1 <= e.x1 && by1 <= e.y1) continue;
+
+      const int dx0 = bx0 - e.margin < 0 ? 0 : bx0 - e.margin;
+      const int dy0 = by0 - e.margin < 0 ? 0 : by0 - e.margin;
+      const int dx1 = bx1 + e.margin >= saveScreenW_ ? saveScreenW_ - 1 : bx1 + e.margin;
+      const int dy1 = by1 + e.margin >= saveScreenH_ ? saveScreenH_ - 1 : by1 + e.margin;
+      if (x0 < dx0 || y0 < dy0 || x1 > dx1 || y1 > dy1) continue;
+
+      const int dw = dx1 - dx0 + 1;
+      const int dh = dy1 - dy0 + 1;
+      freeSaveUnder(i);
+      if (!allocSaveUnder(i, (uint32_t)(dw * dh))) continue;
+      e.x0 = (int16_t)dx0;
+      e.y0 = (int16_t)dy0;
+      e.x1 = (int16_t)dx1;
+      e.y1 = (int16_t)dy1;
+      background_(dx0, dy0, dw, dh, saveArena_ + e.offset);
+      saveStats_.fills++;
+      hit = i;
+    }
+  }
+
+  if (hit < 0) {
+    saveStats_.misses++;
+    background_(x0, y0, w, h, buf);
+    return;
+  }
+
+  SaveUnder& e = saveUnder_[hit];
+  e.lastUse = ++saveTick_;
+  const int stride = e.x1 - e.x0 + 1;
+  const uint16_t* src = saveArena_ + e.offset + (y0 - e.y0) * stride + (x0 - e.x0);
+  for (int yy = 0; yy < h; ++yy) memcpy(buf + yy * w, src + yy * stride, (size_t)w * 2);
+}
+
+bool SpriteLayer::allocSaveUnder(int index, uint32_t pixels) {
+  if (pixels == 0 || pixels > saveArenaPixels_) return false;
+  for (;;) {
+    // First fit między zajętymi prostokątami (najwyżej kMaxSprites).
+    uint32_t start = 0;
+    bool placed = false;
+    while (!placed) {
+      uint32_t next = (uint32_t)saveArenaPixels_;
+      int blocker = -1;
+      for (int i = 0; i < kMaxSprites; i++) {
+        const SaveUnder& o = saveUnder_[i];
+        if (i == index || !o.pixels || o.offset + o.pixels <= start) continue;
+        if (o.offset < next) {
+          next = o.offset;
+          blocker = i;
+        }
+      }
+      if (next >= start + pixels) {
+        placed = true;
+      } else if (blocker < 0) {
+        break;
+      } else {
+        start = saveUnder_[blocker].offset + saveUnder_[blocker].pixels;
+      }
+    }
+    if (placed) {
+      saveUnder_[index].offset = start;
+      saveUnder_[index].pixels = pixels;
+      return true;
+    }
+
+    int lru = -1;
+    for (int i = 0; i < kMaxSprites; i++) {
+      const SaveUnder& o = saveUnder_[i];
+      if (i == index || !o.pixels) continue;
+      if (lru < 0 || o.lastUse < saveUnder_[lru].lastUse) lru = i;
+    }
+    if (lru < 0) return false;
+    freeSaveUnder(lru);
+    saveStats_.evictions++;
+  }
+}
+
+void SpriteLayer::freeSaveUnder(int index) {
+  SaveUnder& e = saveUnder_[index];
+  e.pixels = 0;
+  e.offset = 0;
+  e.x0 = 0;
+  e.y0 = 0;
+  e.x1 = -1;
+  e.y1 = -1;
+}
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 #include <array>
+#include <functional>
 
 // Simple software sprites layer; meant to be composed over a background buffer.
 // Clients fill sprite/missile slots and call renderRegion(...) after the background
@@ -15,6 +17,15 @@ public:
     Double,
   };
 
+  enum class Blend : uint8_t {
+    Key,       // copy, skipping the transparent key (default)
+    Alpha,     // constant alpha (Sprite::alpha, 0..31)
+    Mask1,     // 1 bit per pixel alpha mask, rows padded to bytes, MSB first
+    Mask4,     // 4 bits per pixel alpha mask, rows padded to bytes, high nibble first
+    Additive,  // per-channel saturating add
+    Multiply,  // per-channel multiply (white keeps the background)
+  };
+
   struct Sprite {
     bool active = false;
     int x = 0;
@@ -26,6 +37,12 @@ public:
     Scale scale = Scale::Normal;
     float anchorX = 0.0f;  // 0.0=left, 1.0=right (can be outside range)
     float anchorY = 0.0f;  // 0.0=top, 1.0=bottom (can be outside range)
+    Blend blend = Blend::Key;  // the transparent key is honoured in every mode
+    uint8_t alpha = 31;        // Blend::Alpha, 31 = opaque
+    const uint8_t* alphaMask = nullptr;  // Blend::Mask1 / Blend::Mask4
+    // Blend::Key without horizontal doubling: opaque runs per row (see
+    // SpriteAsset), copied without testing the key. nullptr = per-pixel test.
+    const uint16_t* opaqueSpans = nullptr;
 
     void setAnchor(float ax, float ay) {
       anchorX = ax;
@@ -69,7 +86,70 @@ public:
 
   void renderRegion(int x0, int y0, int w, int h, uint16_t* buf) const;
 
+  // Save-under background cache, for static but expensive backgrounds
+  // (procedural starfields, composed tilemaps). A sprite with save-under keeps
+  // the background of its bounds plus `margin` pixels (clipped to the screen)
+  // in a fixed arena. The rect is rendered once with `background` the first
+  // time a region inside it is needed; after that renderBackground() copies
+  // any region that lies entirely inside a cached rect, so a sprite moving
+  // within its margin only costs the sprite recompose. A sprite that leaves
+  // its rect gets a new one around its current bounds. When the arena is
+  // full the least recently used rects are evicted; regions not covered by
+  // one cached rect are rendered with `background` directly.
+  //
+  // The cache cannot see background changes: call invalidateBackground() for
+  // every background area marked dirty (tile changed, palette shift, scroll).
+  // renderBackground() updates the cache, so it is not re-entrant; do not use
+  // it from a TileWorkers flush.
+  using BackgroundFn = std::function<void(int x0, int y0, int w, int h, uint16_t* buf)>;
+
+  struct SaveUnderStats {
+    uint32_t hits;      // regions copied from the cache
+    uint32_t fills;     // cached rects rendered
+    uint32_t misses;    // regions rendered directly
+    uint32_t evictions;
+    uint32_t invalidations;
+    uint32_t pixelsRestored;
+  };
+
+  // arena: `pixels` RGB565 values; screenW x screenH clips the cached rects.
+  void setSaveUnderArena(uint16_t* arena, size_t pixels, int screenW, int screenH, BackgroundFn background);
+  // margin < 0 turns save-under off for the sprite and frees its rect.
+  void setSaveUnder(int index, int margin);
+
+  // Background for a region (call before renderRegion()).
+  void renderBackground(int x0, int y0, int w, int h, uint16_t* buf);
+  // Drops cached rects overlapping the inclusive rect, or all of them.
+  void invalidateBackground(int x0, int y0, int x1, int y1);
+  void invalidateBackground();
+
+  const SaveUnderStats& saveUnderStats() const { return saveStats_; }
+  void resetSaveUnderStats() { saveStats_ = SaveUnderStats{}; }
+
 private:
+  struct SaveUnder {
+    int16_t margin = -1;  // -1 = off
+    int16_t x0 = 0;       // cached rect, inclusive
+    int16_t y0 = 0;
+    int16_t x1 = -1;
+    int16_t y1 = -1;
+    uint32_t offset = 0;  // in the arena
+    uint32_t pixels = 0;  // 0 = nothing cached
+    uint32_t lastUse = 0;
+  };
+
+  bool allocSaveUnder(int index, uint32_t pixels);
+  void freeSaveUnder(int index);
+
   std::array<Sprite, kMaxSprites> sprites_{};
   std::array<Missile, kMaxMissiles> missiles_{};
+
+  std::array<SaveUnder, kMaxSprites> saveUnder_{};
+  uint16_t* saveArena_ = nullptr;
+  size_t saveArenaPixels_ = 0;
+  int saveScreenW_ = 0;
+  int saveScreenH_ = 0;
+  BackgroundFn background_;
+  uint32_t saveTick_ = 0;
+  SaveUnderStats saveStats_{};
 };
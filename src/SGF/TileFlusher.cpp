@@ -1,13 +1,111 @@
 #include "TileFlusher.h"
 
 #include <algorithm>
+#include <string.h>
 
-void TileFlusher::flush(IRenderTarget& target, uint16_t* regionBuf, const RenderRegionFn& renderRegion) {
-  if (!renderRegion) return;
+#include "FrameCapture.h"
+#include "OverdrawMap.h"
+#include "TileWorkers.h"
+
+// 0 is reserved for "nothing transmitted yet".
+uint32_t TileFlusher::contentHash(const uint16_t* pix, int n) {
+  const uint32_t h = FrameCapture::hash565(pix, n > 0 ? (size_t)n : 0);
+  return h ? h : 1u;
+}
+
+void TileFlusher::enableTileHashing(uint32_t* hashes, int count) {
+  tileHashes = (hashes && count > 0) ? hashes : nullptr;
+  tileHashCount = tileHashes ? count : 0;
+  invalidateTileHashes();
+}
+
+void TileFlusher::disableTileHashing() {
+  tileHashes = nullptr;
+  tileHashCount = 0;
+}
+
+void TileFlusher::invalidateTileHashes() {
+  for (int i = 0; i < tileHashCount; i++) tileHashes[i] = 0;
+}
 
-  dirty.clip(target.width(), target.height());
+bool TileFlusher::prepare(const IRenderTarget& target, int* cols) {
+  const int screenW = pixelDoubling ? target.width() / 2 : target.width();
+  const int screenH = pixelDoubling ? target.height() / 2 : target.height();
+  const int c = (screenW + tileW - 1) / tileW;
+  const int rows = (screenH + tileH - 1) / tileH;
+  const bool hashing = tileHashes && c * rows <= tileHashCount;
+
+  dirty.clip(screenW, screenH);
+  if (hashing) {
+    // Rozłączne recty: części kafla wysyłane w blitDirtyPart() się nie nakładają.
+    dirty.mergeAll();
+    unsnappedCount = dirty.count();
+    for (int i = 0; i < unsnappedCount; i++) unsnapped[i] = dirty[i];
+    dirty.snap(tileW, tileH, screenW, screenH);
+  }
   dirty.mergeAll();
 
+  if (cols) *cols = c;
+  return hashing;
+}
+
+bool TileFlusher::tileUnchanged(int x, int y, int cols, uint32_t h) {
+  uint32_t& slot = tileHashes[(y / tileH) * cols + (x / tileW)];
+  if (slot == h) {
+    hashHits++;
+    return true;
+  }
+  slot = h;
+  hashMisses++;
+  return false;
+}
+
+void TileFlusher::blitTile(IRenderTarget& target, int x, int y, int w, int h, uint16_t* buf) {
+  // Przed blitem: blit565InPlace zostawia bufor zamieniony.
+  if (overdraw) overdraw->recordSent(x, y, w, h, buf);
+  if (pixelDoubling) {
+    target.blit565Scaled2x(x, y, w, h, buf);
+  } else {
+    target.blit565InPlace(x, y, w, h, buf);
+  }
+}
+
+void TileFlusher::blitDirtyPart(IRenderTarget& target, int x, int y, int w, int h, uint16_t* buf,
+                                const RenderRegionFn& renderRegion) {
+  // Części kafla pokryte przez recty sprzed snap(), każda osobnym blitem.
+  bool first = true;
+  for (int i = 0; i < unsnappedCount; i++) {
+    const Rect& r = unsnapped[i];
+    const int x0 = std::max<int>(r.x0, x);
+    const int y0 = std::max<int>(r.y0, y);
+    const int x1 = std::min<int>(r.x1, x + w - 1);
+    const int y1 = std::min<int>(r.y1, y + h - 1);
+    if (x1 < x0 || y1 < y0) continue;
+    const int sw = x1 - x0 + 1;
+    const int sh = y1 - y0 + 1;
+    if (first) {
+      // Pierwsza część z wyrenderowanego kafla: zagęszczamy wiersze na początek
+      // bufora; cel nigdy nie wyprzedza źródła.
+      if (sw < w || sh < h) {
+        const uint16_t* src = buf + (y0 - y) * w + (x0 - x);
+        for (int row = 0; row < sh; row++) memmove(buf + row * sw, src + row * w, (size_t)sw * 2);
+      }
+      first = false;
+    } else {
+      // Bufor jest już nadpisany przez poprzednią część: renderujemy tylko tę.
+      renderRegion(x0, y0, sw, sh, buf);
+      if (overdraw) overdraw->recordRendered(sw, sh);
+    }
+    blitTile(target, x0, y0, sw, sh, buf);
+  }
+}
+
+void TileFlusher::flush(IRenderTarget& target, uint16_t* regionBuf, const RenderRegionFn& renderRegion) {
+  if (!regionBuf || !renderRegion || dirty.count() == 0) return;
+
+  int cols = 0;
+  const bool hashing = prepare(target, &cols);
+
   for (int i = 0; i < dirty.count(); i++) {
     const Rect& r = dirty[i];
     for (int y = r.y0; y <= r.y1; y += tileH) {
@@ -15,9 +113,63 @@ void TileFlusher::flush(IRenderTarget& target, uint16_t* regionBuf, const Render
       for (int x = r.x0; x <= r.x1; x += tileW) {
         int ww = std::min(tileW, r.x1 - x + 1);
         renderRegion(x, y, ww, hh, regionBuf);
-        target.blit565(x, y, ww, hh, regionBuf);
+        if (overdraw) overdraw->recordRendered(ww, hh);
+        if (!hashing) {
+          blitTile(target, x, y, ww, hh, regionBuf);
+        } else if (!tileUnchanged(x, y, cols, contentHash(regionBuf, ww * hh))) {
+          blitDirtyPart(target, x, y, ww, hh, regionBuf, renderRegion);
+        }
+      }
+    }
+  }
+  dirty.clear();
+}
+
+void TileFlusher::flush(IRenderTarget& target, TileWorkers& workers, const RenderRegionFn& renderRegion) {
+  if (!renderRegion || dirty.count() == 0) return;
+  // Za małe (albo brak) bufory workerów: nic nie renderujemy, recty zostają.
+  if (!workers.buffer(0, 0) || workers.bufferPixels() < tileW * tileH) return;
+  if (!workers.running()) {
+    flush(target, workers.buffer(0, 0), renderRegion);
+    return;
+  }
+
+  int cols = 0;
+  const bool hashing = prepare(target, &cols);
+  TileWorkers::Tile* tiles = workers.tileBuffer();
+
+  auto runBatch = [&](int n) {
+    workers.dispatch(n, renderRegion, hashing);
+    for (int j = 0; j < n; j++) {
+      const TileWorkers::Tile& t = tiles[j];
+      uint32_t h = 0;
+      uint16_t* buf = workers.acquire(j, &h);
+      if (overdraw) overdraw->recordRendered(t.w, t.h);
+      if (!hashing) {
+        blitTile(target, t.x, t.y, t.w, t.h, buf);
+      } else if (!tileUnchanged(t.x, t.y, cols, h)) {
+        blitDirtyPart(target, t.x, t.y, t.w, t.h, buf, renderRegion);
+      }
+      workers.release(j);
+    }
+    workers.finishBatch();
+  };
+
+  int n = 0;
+  for (int i = 0; i < dirty.count(); i++) {
+    const Rect& r = dirty[i];
+    for (int y = r.y0; y <= r.y1; y += tileH) {
+      int hh = std::min(tileH, r.y1 - y + 1);
+      for (int x = r.x0; x <= r.x1; x += tileW) {
+        int ww = std::min(tileW, r.x1 - x + 1);
+        tiles[n++] = TileWorkers::Tile{(int16_t)x, (int16_t)y, (int16_t)ww, (int16_t)hh};
+        if (n == TileWorkers::kMaxTiles) {
+          runBatch(n);
+          n = 0;
+        }
       }
     }
   }
+  if (n > 0) runBatch(n);
   dirty.clear();
 }
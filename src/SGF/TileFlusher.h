@@ -6,6 +6,9 @@
 #include "DirtyRects.h"
 #include "IRenderTarget.h"
 
+class OverdrawMap;
+class TileWorkers;
+
 class TileFlusher {
 public:
   using RenderRegionFn = std::function<void(int x0, int y0, int w, int h, uint16_t* buf)>;
@@ -13,10 +16,69 @@ public:
   TileFlusher(DirtyRects& dirty, int tileW, int tileH)
     : dirty(dirty), tileW(tileW), tileH(tileH) {}
 
+  // regionBuf (tileW * tileH pixels) is handed to target.blit565InPlace(), so
+  // its content is undefined after each tile.
   void flush(IRenderTarget& target, uint16_t* regionBuf, const RenderRegionFn& renderRegion);
+  // Worker mode: tiles are rendered concurrently into the workers' buffers and
+  // blitted in order from the calling thread. renderRegion must be re-entrant
+  // (see TileWorkers). Falls back to flush() with the first worker buffer when
+  // the pool is not running. Does nothing, keeping the dirty rects, when the
+  // worker buffers are missing or smaller than tileW * tileH.
+  void flush(IRenderTarget& target, TileWorkers& workers, const RenderRegionFn& renderRegion);
+
+  // Optional tile hashing: keeps one hash per screen tile (tileW x tileH grid)
+  // of the last transmitted content and skips blit565 when a freshly rendered
+  // tile hashes the same. Dirty rects are expanded to the tile grid in this
+  // mode so whole tiles are hashed, but a changed tile only sends the parts
+  // covered by the original (merged) dirty rects; when a tile holds more than
+  // one, the others are rendered again at their own size. `hashes` must hold
+  // ceil(W/tileW) * ceil(H/tileH) entries for the target, otherwise flush() falls back to the plain path. Call
+  // invalidateTileHashes() after drawing to the target outside the flusher
+  // (fillScreen565, rotation change, ...).
+  void enableTileHashing(uint32_t* hashes, int count);
+  void disableTileHashing();
+  void invalidateTileHashes();
+  bool tileHashingEnabled() const { return tileHashes != nullptr; }
+
+  uint32_t tileHashHits() const { return hashHits; }
+  uint32_t tileHashMisses() const { return hashMisses; }
+  void resetTileHashStats() {
+    hashHits = 0;
+    hashMisses = 0;
+  }
+
+  // Low-resolution mode: dirty rects, tiles and renderRegion coordinates are in
+  // half-resolution space (target.width() / 2 x target.height() / 2) and every
+  // tile goes out through target.blit565Scaled2x(). Tile hashes are kept per
+  // logical tile, so call invalidateTileHashes() when switching.
+  void setPixelDoubling(bool enabled) { pixelDoubling = enabled; }
+  bool pixelDoublingEnabled() const { return pixelDoubling; }
+
+  // Debug: every rendered tile and every blit is reported to map before it
+  // goes out (see OverdrawMap). nullptr turns it off.
+  void setOverdraw(OverdrawMap* map) { overdraw = map; }
+  OverdrawMap* overdrawMap() const { return overdraw; }
+
+  // Hash used for tile comparison (FrameCapture::hash565); never returns 0.
+  static uint32_t contentHash(const uint16_t* pix, int n);
 
 private:
   DirtyRects& dirty;
   int tileW;
   int tileH;
+  bool pixelDoubling = false;
+  OverdrawMap* overdraw = nullptr;
+
+  uint32_t* tileHashes = nullptr;
+  int tileHashCount = 0;
+  uint32_t hashHits = 0;
+  uint32_t hashMisses = 0;
+  Rect unsnapped[DirtyRects::MAX];  // hashing mode: merged dirty rects before snap()
+  int unsnappedCount = 0;
+
+  bool prepare(const IRenderTarget& target, int* cols);
+  bool tileUnchanged(int x, int y, int cols, uint32_t h);
+  void blitTile(IRenderTarget& target, int x, int y, int w, int h, uint16_t* buf);
+  void blitDirtyPart(IRenderTarget& target, int x, int y, int w, int h, uint16_t* buf,
+                     const RenderRegionFn& renderRegion);
 };
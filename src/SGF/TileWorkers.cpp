@@ -0,0 +1,154 @@
+#include "TileWorkers.h"
+
+#include "TileFlusher.h"
+
+#if defined(__ZEPHYR__)
+K_THREAD_STACK_ARRAY_DEFINE(sgfTileWorkerStacks, TileWorkers::kMaxWorkers, SGF_TILE_WORKER_STACK_SIZE);
+
+void TileWorkers::threadEntry(void* self, void* index, void* unused) {
+  (void)unused;
+  static_cast<TileWorkers*>(self)->workerLoop((int)(intptr_t)index);
+}
+#endif
+
+TileWorkers::TileWorkers(uint16_t* arena, int bufferPixels, int workerCount)
+  : arena(arena), slotPixels(bufferPixels) {
+  if (workerCount < 1) workerCount = 1;
+  if (workerCount > kMaxWorkers) workerCount = kMaxWorkers;
+  count = workerCount;
+}
+
+TileWorkers::~TileWorkers() {
+  stop();
+}
+
+bool TileWorkers::start() {
+  if (runningFlag) return true;
+  if (!arena || slotPixels <= 0) return false;
+
+  stopping.store(false);
+  for (int i = 0; i < count; i++) {
+    Worker& w = workers[i];
+    w.produced.store(0);
+    w.consumed.store(0);
+    w.finishedBatch.store(batch);
+#if defined(__ZEPHYR__)
+    k_sem_init(&w.wake, 0, 1);
+    k_thread_create(&w.thread, sgfTileWorkerStacks[i], K_THREAD_STACK_SIZEOF(sgfTileWorkerStacks[i]),
+                    threadEntry, this, (void*)(intptr_t)i, nullptr,
+                    k_thread_priority_get(k_current_get()), 0, K_NO_WAIT);
+#else
+    w.wakeCount = 0;
+    w.thread = std::thread([this, i]() { workerLoop(i); });
+#endif
+  }
+  runningFlag = true;
+  return true;
+}
+
+void TileWorkers::stop() {
+  if (!runningFlag) return;
+
+  stopping.store(true);
+  for (int i = 0; i < count; i++) {
+    wakeWorker(i);
+#if defined(__ZEPHYR__)
+    k_thread_join(&workers[i].thread, K_FOREVER);
+#else
+    workers[i].thread.join();
+#endif
+  }
+  runningFlag = false;
+}
+
+void TileWorkers::wakeWorker(int index) {
+  Worker& w = workers[index];
+#if defined(__ZEPHYR__)
+  k_sem_give(&w.wake);
+#else
+  {
+    std::lock_guard<std::mutex> lock(w.mutex);
+    w.wakeCount++;
+  }
+  w.cv.notify_one();
+#endif
+}
+
+void TileWorkers::waitWake(int index) {
+  Worker& w = workers[index];
+#if defined(__ZEPHYR__)
+  k_sem_take(&w.wake, K_FOREVER);
+#else
+  std::unique_lock<std::mutex> lock(w.mutex);
+  w.cv.wait(lock, [&w]() { return w.wakeCount > 0; });
+  w.wakeCount--;
+#endif
+}
+
+void TileWorkers::yieldNow() {
+#if defined(__ZEPHYR__)
+  k_yield();
+#else
+  std::this_thread::yield();
+#endif
+}
+
+void TileWorkers::workerLoop(int index) {
+  Worker& w = workers[index];
+  while (true) {
+    waitWake(index);
+    if (stopping.load(std::memory_order_acquire)) return;
+
+    const uint32_t myBatch = batch;
+    const int n = tileCountValue;
+    const bool hashing = hashingValue;
+    const RenderRegionFn& render = *renderFn;
+
+    uint32_t k = 0;
+    for (int j = index; j < n; j += count, k++) {
+      // Czekamy na wolny slot (ring SPSC: produced pisze worker, consumed wątek SPI).
+      while (k - w.consumed.load(std::memory_order_acquire) >= (uint32_t)kSlotsPerWorker) yieldNow();
+
+      const int slot = (int)(k % kSlotsPerWorker);
+      uint16_t* buf = buffer(index, slot);
+      const Tile& t = tiles[j];
+      render(t.x, t.y, t.w, t.h, buf);
+      if (hashing) w.hashes[slot] = TileFlusher::contentHash(buf, t.w * t.h);
+      w.produced.store(k + 1, std::memory_order_release);
+    }
+    w.finishedBatch.store(myBatch, std::memory_order_release);
+  }
+}
+
+void TileWorkers::dispatch(int tileCount, const RenderRegionFn& render, bool hashing) {
+  tileCountValue = tileCount;
+  renderFn = &render;
+  hashingValue = hashing;
+  batch++;
+  for (int i = 0; i < count; i++) {
+    workers[i].produced.store(0, std::memory_order_relaxed);
+    workers[i].consumed.store(0, std::memory_order_relaxed);
+    wakeWorker(i);
+  }
+}
+
+uint16_t* TileWorkers::acquire(int tileIndex, uint32_t* hash) {
+  Worker& w = workers[tileIndex % count];
+  const uint32_t k = (uint32_t)(tileIndex / count);
+  while (w.produced.load(std::memory_order_acquire) <= k) yieldNow();
+
+  const int slot = (int)(k % kSlotsPerWorker);
+  if (hash) *hash = w.hashes[slot];
+  return buffer(tileIndex % count, slot);
+}
+
+void TileWorkers::release(int tileIndex) {
+  Worker& w = workers[tileIndex % count];
+  w.consumed.store((uint32_t)(tileIndex / count) + 1, std::memory_order_release);
+}
+
+void TileWorkers::finishBatch() {
+  for (int i = 0; i < count; i++) {
+    while (workers[i].finishedBatch.load(std::memory_order_acquire) != batch) yieldNow();
+  }
+}
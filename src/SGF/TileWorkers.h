@@ -0,0 +1,110 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <functional>
+
+#if defined(__ZEPHYR__)
+extern "C" {
+  #include <zephyr/kernel.h>
+}
+#else
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+#ifndef SGF_TILE_WORKER_STACK_SIZE
+#define SGF_TILE_WORKER_STACK_SIZE 2048
+#endif
+
+// Fixed pool of tile render workers for TileFlusher::flush(target, workers, ...).
+// Workers are Zephyr threads on device and std::thread on the host. Each worker
+// renders every N-th tile into its own region buffers and hands finished tiles
+// to the flushing thread (the SPI owner) through a lock-free single-producer /
+// single-consumer ring, so blits keep their order.
+//
+// The render callback runs concurrently on several threads in this mode and must
+// be re-entrant: it may read shared scene state but must only write to the buffer
+// it was given.
+//
+// On Zephyr the thread stacks are static, so only one TileWorkers instance can be
+// running at a time.
+class TileWorkers {
+public:
+  using RenderRegionFn = std::function<void(int x0, int y0, int w, int h, uint16_t* buf)>;
+
+  static constexpr int kMaxWorkers = 4;
+  static constexpr int kSlotsPerWorker = 2;
+  static constexpr int kMaxTiles = 128;  // tiles per dispatched batch
+
+  struct Tile {
+    int16_t x, y, w, h;
+  };
+
+  // arena holds workerCount * kSlotsPerWorker buffers of bufferPixels each;
+  // bufferPixels must be at least tileW * tileH of the flusher.
+  TileWorkers(uint16_t* arena, int bufferPixels, int workerCount);
+  ~TileWorkers();
+
+  TileWorkers(const TileWorkers&) = delete;
+  TileWorkers& operator=(const TileWorkers&) = delete;
+
+  bool start();
+  void stop();
+  bool running() const { return runningFlag; }
+
+  int workerCount() const { return count; }
+  int bufferPixels() const { return slotPixels; }
+  uint16_t* buffer(int worker, int slot) const {
+    return arena + (worker * kSlotsPerWorker + slot) * slotPixels;
+  }
+
+private:
+  friend class TileFlusher;
+
+  struct Worker {
+    std::atomic<uint32_t> produced{0};
+    std::atomic<uint32_t> consumed{0};
+    std::atomic<uint32_t> finishedBatch{0};
+    uint32_t hashes[kSlotsPerWorker] = {};
+#if defined(__ZEPHYR__)
+    struct k_thread thread;
+    struct k_sem wake;
+#else
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable cv;
+    uint32_t wakeCount = 0;
+#endif
+  };
+
+  // TileFlusher side (flushing thread only).
+  Tile* tileBuffer() { return tiles; }
+  void dispatch(int tileCount, const RenderRegionFn& render, bool hashing);
+  uint16_t* acquire(int tileIndex, uint32_t* hash);
+  void release(int tileIndex);
+  void finishBatch();
+
+  void workerLoop(int index);
+#if defined(__ZEPHYR__)
+  static void threadEntry(void* self, void* index, void* unused);
+#endif
+  void wakeWorker(int index);
+  void waitWake(int index);
+  static void yieldNow();
+
+  uint16_t* arena;
+  int slotPixels;
+  int count;
+  bool runningFlag = false;
+
+  Tile tiles[kMaxTiles];
+  int tileCountValue = 0;
+  const RenderRegionFn* renderFn = nullptr;
+  bool hashingValue = false;
+  uint32_t batch = 0;
+  std::atomic<bool> stopping{false};
+
+  Worker workers[kMaxWorkers];
+};
@@ -0,0 +1,211 @@
+#include "TimerWheel.h"
+
+namespace {
+
+constexpr uint32_t kSlotMask = TimerWheel::kSlots - 1;
+constexpr uint32_t kRangeTicks = 1u << (TimerWheel::kSlotBits * TimerWheel::kLevels);
+
+}  // namespace
+
+TimerWheel::TimerWheel(uint32_t tickUs) : tick(tickUs ? tickUs : 1) {
+  for (int i = 0; i < kMaxTimers; i++) {
+    timers[i].gen = 0;
+    timers[i].list = -1;
+  }
+  clear();
+}
+
+void TimerWheel::clear() {
+  for (int i = 0; i <= kFiring; i++) heads[i] = -1;
+  occupied0 = 0;
+  for (int i = 0; i < kMaxTimers; i++) {
+    if (timers[i].list != -1) timers[i].gen++;
+    timers[i].list = -1;
+    timers[i].next = (int16_t)(i + 1 < kMaxTimers ? i + 1 : -1);
+  }
+  freeHead = 0;
+  live = 0;
+}
+
+void TimerWheel::resync(uint32_t nowUs) {
+  lastUs = nowUs;
+  started = true;
+}
+
+uint32_t TimerWheel::toTicks(uint32_t us) const {
+  uint32_t t = us / tick + (us % tick ? 1 : 0);
+  return t ? t : 1;
+}
+
+int TimerWheel::index(Handle handle) const {
+  int i = (int)(handle & 0xFFFFu) - 1;
+  if (i < 0 || i >= kMaxTimers) return -1;
+  const Timer& t = timers[i];
+  if (t.list < 0 || t.gen != (uint16_t)(handle >> 16)) return -1;
+  return i;
+}
+
+void TimerWheel::insert(int i) {
+  Timer& t = timers[i];
+  int32_t delta = (int32_t)(t.expires - nextTick);
+  uint32_t when = t.expires;
+  if (delta < 0) {
+    when = nextTick;
+    delta = 0;
+  } else if ((uint32_t)delta >= kRangeTicks) {
+    // Poza zasięgiem koła: odkładamy do najdalszego slotu, cascade() przeliczy.
+    when = nextTick + kRangeTicks - 1;
+    delta = (int32_t)(kRangeTicks - 1);
+  }
+
+  int level = 0;
+  while (level < kLevels - 1 && (uint32_t)delta >= (1u << (kSlotBits * (level + 1)))) level++;
+  const int list = level * kSlots + (int)((when >> (kSlotBits * level)) & kSlotMask);
+
+  t.list = (int16_t)list;
+  t.prev = -1;
+  t.next = heads[list];
+  if (t.next >= 0) timers[t.next].prev = (int16_t)i;
+  heads[list] = (int16_t)i;
+  if (level == 0) occupied0 |= 1ull << list;
+}
+
+void TimerWheel::unlink(int i) {
+  Timer& t = timers[i];
+  if (t.prev >= 0) {
+    timers[t.prev].next = t.next;
+  } else {
+    heads[t.list] = t.next;
+    if (t.next < 0 && t.list < kSlots) occupied0 &= ~(1ull << t.list);
+  }
+  if (t.next >= 0) timers[t.next].prev = t.prev;
+  t.next = -1;
+  t.prev = -1;
+}
+
+void TimerWheel::release(int i) {
+  Timer& t = timers[i];
+  t.list = -1;
+  t.gen++;
+  t.next = freeHead;
+  freeHead = (int16_t)i;
+  live--;
+}
+
+TimerWheel::Handle TimerWheel::schedule(uint32_t delayUs, Callback cb, void* user, uint32_t arg, uint32_t periodUs) {
+  if (!cb || freeHead < 0) return kInvalid;
+
+  const int i = freeHead;
+  Timer& t = timers[i];
+  freeHead = t.next;
+  live++;
+
+  t.expires = nextTick + toTicks(delayUs) - 1;
+  t.periodTicks = periodUs ? toTicks(periodUs) : 0;
+  t.cb = cb;
+  t.user = user;
+  t.arg = arg;
+  insert(i);
+  return ((Handle)t.gen << 16) | (Handle)(i + 1);
+}
+
+bool TimerWheel::cancel(Handle handle) {
+  const int i = index(handle);
+  if (i < 0) return false;
+  unlink(i);
+  release(i);
+  return true;
+}
+
+bool TimerWheel::pending(Handle handle) const {
+  return index(handle) >= 0;
+}
+
+void TimerWheel::cascade(int level, int slot) {
+  const int list = level * kSlots + slot;
+  int i = heads[list];
+  heads[list] = -1;
+  while (i >= 0) {
+    const int next = timers[i].next;
+    insert(i);
+    i = next;
+  }
+}
+
+int TimerWheel::runTick() {
+  const uint32_t now = nextTick;
+  const int slot = (int)(now & kSlotMask);
+
+  // Na granicy bloku przenosimy niższy poziom w dół, zaczynając od najwyższego.
+  if (slot == 0) {
+    int level = 1;
+    while (level < kLevels) {
+      const int s = (int)((now >> (kSlotBits * level)) & kSlotMask);
+      if (s != 0 || level == kLevels - 1) break;
+      level++;
+    }
+    for (; level >= 1; level--) cascade(level, (int)((now >> (kSlotBits * level)) & kSlotMask));
+  }
+
+  nextTick = now + 1;
+
+  // Slot odpinamy przed odpaleniem: timer, który wraca za kSlots ticków
+  // (okres 64 albo schedule() z callbacku), trafia do tego samego slotu
+  // i nie może odpalić drugi raz w tym ticku.
+  heads[kFiring] = heads[slot];
+  heads[slot] = -1;
+  occupied0 &= ~(1ull << slot);
+  for (int j = heads[kFiring]; j >= 0; j = timers[j].next) timers[j].list = kFiring;
+
+  int fired = 0;
+  while (heads[kFiring] >= 0) {
+    const int i = heads[kFiring];
+    Timer& t = timers[i];
+    unlink(i);
+    const Callback cb = t.cb;
+    void* const user = t.user;
+    const uint32_t arg = t.arg;
+    if (t.periodTicks) {
+      t.expires += t.periodTicks;
+      insert(i);
+    } else {
+      release(i);
+    }
+    cb(user, arg);
+    fired++;
+  }
+  return fired;
+}
+
+int TimerWheel::advance(uint32_t nowUs) {
+  if (!started) {
+    resync(nowUs);
+    return 0;
+  }
+
+  uint32_t ticks = (nowUs - lastUs) / tick;
+  lastUs += ticks * tick;
+
+  if (live == 0) {
+    nextTick += ticks;
+    return 0;
+  }
+
+  int fired = 0;
+  while (ticks) {
+    const uint32_t slot = nextTick & kSlotMask;
+    if (slot != 0) {
+      // Puste sloty do końca bloku przeskakujemy bez odwiedzania.
+      const uint64_t ahead = occupied0 >> slot;
+      const uint32_t toBlockEnd = kSlots - slot;
+      uint32_t skip = ahead ? (uint32_t)__builtin_ctzll(ahead) : toBlockEnd;
+      if (skip > ticks) skip = ticks;
+      nextTick += skip;
+      ticks -= skip;
+      if (skip == toBlockEnd || !ticks) continue;
+    }
+    fired += runTick();
+    ticks--;
+  }
+  return fired;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <stdint.h>
+
+// Fixed-capacity hierarchical timer wheel.
+// Three levels of 64 slots cover 2^18 ticks (262 s with the default 1 ms tick);
+// longer delays are re-filed when their slot cascades. schedule() and cancel()
+// are O(1); advance() skips empty ticks with a slot bitmap, so its cost is
+// dominated by the timers that actually expire or cascade. Callbacks are plain
+// function pointers with a user pointer and a 32-bit argument, so nothing is
+// allocated.
+//
+// Drive it from Game (Game::setTimers) or call advance(nowUs) once per frame.
+// Callbacks may schedule and cancel timers, including their own.
+class TimerWheel {
+public:
+  using Callback = void (*)(void* user, uint32_t arg);
+  using Handle = uint32_t;
+
+  static constexpr Handle kInvalid = 0;
+  static constexpr int kMaxTimers = 64;
+  static constexpr int kLevels = 3;
+  static constexpr int kSlotBits = 6;
+  static constexpr int kSlots = 1 << kSlotBits;
+
+  explicit TimerWheel(uint32_t tickUs = 1000);
+
+  // Drops all timers.
+  void clear();
+  // Sets the time base without touching pending timers (e.g. after a pause).
+  void resync(uint32_t nowUs);
+
+  // Fires cb(user, arg) once delayUs has passed (rounded up to whole ticks,
+  // at least one), then every periodUs if periodUs != 0. Returns kInvalid when
+  // all kMaxTimers are in use.
+  Handle schedule(uint32_t delayUs, Callback cb, void* user, uint32_t arg = 0, uint32_t periodUs = 0);
+  bool cancel(Handle handle);
+  bool pending(Handle handle) const;
+
+  // Processes every tick up to nowUs; returns the number of callbacks run.
+  int advance(uint32_t nowUs);
+
+  int count() const { return live; }
+  uint32_t tickUs() const { return tick; }
+
+private:
+  struct Timer {
+    uint32_t expires;  // absolute tick
+    uint32_t periodTicks;
+    Callback cb;
+    void* user;
+    uint32_t arg;
+    int16_t next;
+    int16_t prev;
+    int16_t list;  // level * kSlots + slot, -1 when free
+    uint16_t gen;
+  };
+
+  int index(Handle handle) const;
+  uint32_t toTicks(uint32_t us) const;
+  void insert(int i);
+  void unlink(int i);
+  void release(int i);
+  void cascade(int level, int slot);
+  int runTick();
+
+  // Timers of the tick being run, detached from their slot (cancel() still
+  // finds them there).
+  static constexpr int kFiring = kLevels * kSlots;
+
+  uint32_t tick;
+  bool started = false;
+  uint32_t lastUs = 0;
+  uint32_t nextTick = 0;  // first tick not processed yet
+  int live = 0;
+  int16_t freeHead = -1;
+  uint64_t occupied0 = 0;  // non-empty level 0 slots
+  int16_t heads[kLevels * kSlots + 1];
+  Timer timers[kMaxTimers];
+};
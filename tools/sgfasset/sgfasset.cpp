@@ -0,0 +1,917 @@
+// sgfasset - host asset compiler for SGF sprites.
+//
+// Converts PNG images into inline constexpr headers of SpriteAsset descriptors
+// (src/SGF/SpriteAsset.h): RGB565 pixels with a transparent key, opaque-span
+// tables, palette-indexed data, Mask1/Mask4 alpha masks and 1-bit collision
+// masks. For every asset it prints the size of each candidate format and an
+// estimated per-blit cost, and with --format auto picks the fastest (or, with
+// --prefer size, the smallest) format.
+//
+// With --pack the assets (plus raw data files such as tilemap chunks) go
+// into a binary pack for AssetStore instead, and the header only lists their
+// handles.
+//
+// Build (no dependencies, PNG decoding is built in):
+//   c++ -std=c++17 -O2 -o sgfasset tools/sgfasset/sgfasset.cpp
+//
+// Usage:
+//   sgfasset [options] -o assets.h image.png [[options] image.png ...]
+//   sgfasset [options] --pack level.sgfp -o level.h image.png chunk.bin ...
+//
+// Per-image options (apply to the images that follow them):
+//   --name NAME          identifier stem (default: file name); emits kNAME
+//   --format F           auto | rgb565 | spans | indexed8 | indexed4 (default auto)
+//   --prefer P           speed | size, used by --format auto (default speed)
+//   --mask M             auto | none | 1 | 4 (default auto: from the alpha channel)
+//   --key RRGGBB         colour treated as transparent in images without alpha
+//   --anchor X,Y         anchor in pixels (default 0,0)
+//   --frames N           horizontal strip of N equal frames (SpriteSheet layout)
+//   --collision          also emit a 1-bit collision mask (not stored in packs)
+//   --grid W,H           dimensions recorded for the following raw data files
+//                        (any input not ending in .png), e.g. tiles per chunk
+// Global options:
+//   -o FILE              output header (required)
+//   --namespace NS       wrap the assets in namespace NS
+//   --pack FILE          write an AssetStore pack; the header gets handles
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+[[noreturn]] void fail(const std::string& msg) {
+  fprintf(stderr, "sgfasset: %s\n", msg.c_str());
+  exit(1);
+}
+
+// ---------------------------------------------------------------- inflate
+
+class Inflater {
+public:
+  Inflater(const uint8_t* data, size_t len) : src(data), srcLen(len) {}
+
+  std::vector<uint8_t> run() {
+    bool last = false;
+    while (!last) {
+      last = bits(1) != 0;
+      const uint32_t type = bits(2);
+      if (type == 0) {
+        stored();
+      } else if (type == 1) {
+        fixedTables();
+        block();
+      } else if (type == 2) {
+        dynamicTables();
+        block();
+      } else {
+        fail("invalid deflate block");
+      }
+    }
+    return out;
+  }
+
+private:
+  struct Huffman {
+    uint16_t count[16];
+    uint16_t symbol[320];
+  };
+
+  uint32_t bits(int need) {
+    uint32_t v = bitBuf;
+    while (bitCount < need) {
+      if (pos >= srcLen) fail("truncated deflate stream");
+      v |= (uint32_t)src[pos++] << bitCount;
+      bitCount += 8;
+    }
+    bitBuf = v >> need;
+    bitCount -= need;
+    return v & ((1u << need) - 1u);
+  }
+
+  static void build(Huffman& h, const uint8_t* lengths, int n) {
+    memset(h.count, 0, sizeof(h.count));
+    for (int i = 0; i < n; i++) h.count[lengths[i]]++;
+    h.count[0] = 0;
+    uint16_t offs[16];
+    offs[1] = 0;
+    for (int len = 1; len < 15; len++) offs[len + 1] = (uint16_t)(offs[len] + h.count[len]);
+    for (int i = 0; i < n; i++) {
+      if (lengths[i]) h.symbol[offs[lengths[i]]++] = (uint16_t)i;
+    }
+  }
+
+  int decode(const Huffman& h) {
+    int code = 0, first = 0, index = 0;
+    for (int len = 1; len < 16; len++) {
+      code |= (int)bits(1);
+      const int count = h.count[len];
+      if (code - count < first) return h.symbol[index + (code - first)];
+      index += count;
+      first += count;
+      first <<= 1;
+      code <<= 1;
+    }
+    fail("invalid Huffman code");
+  }
+
+  void stored() {
+    bitBuf = 0;
+    bitCount = 0;
+    if (pos + 4 > srcLen) fail("truncated stored block");
+    const uint32_t len = src[pos] | (src[pos + 1] << 8);
+    const uint32_t nlen = src[pos + 2] | (src[pos + 3] << 8);
+    pos += 4;
+    if ((len ^ 0xFFFFu) != nlen || pos + len > srcLen) fail("invalid stored block");
+    out.insert(out.end(), src + pos, src + pos + len);
+    pos += len;
+  }
+
+  void fixedTables() {
+    uint8_t l[320];
+    int i = 0;
+    for (; i < 144; i++) l[i] = 8;
+    for (; i < 256; i++) l[i] = 9;
+    for (; i < 280; i++) l[i] = 7;
+    for (; i < 288; i++) l[i] = 8;
+    build(lit, l, 288);
+    for (i = 0; i < 30; i++) l[i] = 5;
+    build(dist, l, 30);
+  }
+
+  void dynamicTables() {
+    static const uint8_t kOrder[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+    const int nlen = (int)bits(5) + 257;
+    const int ndist = (int)bits(5) + 1;
+    const int ncode = (int)bits(4) + 4;
+    uint8_t l[320] = {0};
+    for (int i = 0; i < ncode; i++) l[kOrder[i]] = (uint8_t)bits(3);
+    Huffman lencode;
+    build(lencode, l, 19);
+
+    memset(l, 0, sizeof(l));
+    int i = 0;
+    while (i < nlen + ndist) {
+      int sym = decode(lencode);
+      if (sym < 16) {
+        l[i++] = (uint8_t)sym;
+        continue;
+      }
+      uint8_t value = 0;
+      int repeat = 0;
+      if (sym == 16) {
+        if (i == 0) fail("repeat without previous length");
+        value = l[i - 1];
+        repeat = 3 + (int)bits(2);
+      } else if (sym == 17) {
+        repeat = 3 + (int)bits(3);
+      } else {
+        repeat = 11 + (int)bits(7);
+      }
+      if (i + repeat > nlen + ndist) fail("too many code lengths");
+      while (repeat--) l[i++] = value;
+    }
+    build(lit, l, nlen);
+    build(dist, l + nlen, ndist);
+  }
+
+  void block() {
+    static const uint16_t kLenBase[29] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                          31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static const uint8_t kLenExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                          2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    static const uint16_t kDistBase[30] = {1,   2,   3,   4,   5,   7,    9,    13,   17,   25,
+                                           33,  49,  65,  97,  129, 193,  257,  385,  513,  769,
+                                           1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+    static const uint8_t kDistExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                           6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+    while (true) {
+      int sym = decode(lit);
+      if (sym < 256) {
+        out.push_back((uint8_t)sym);
+      } else if (sym == 256) {
+        return;
+      } else {
+        sym -= 257;
+        if (sym >= 29) fail("invalid length symbol");
+        const size_t len = kLenBase[sym] + bits(kLenExtra[sym]);
+        const int ds = decode(dist);
+        if (ds >= 30) fail("invalid distance symbol");
+        const size_t d = kDistBase[ds] + bits(kDistExtra[ds]);
+        if (d > out.size()) fail("distance too far back");
+        const size_t from = out.size() - d;
+        for (size_t k = 0; k < len; k++) out.push_back(out[from + k]);
+      }
+    }
+  }
+
+  const uint8_t* src;
+  size_t srcLen;
+  size_t pos = 0;
+  uint32_t bitBuf = 0;
+  int bitCount = 0;
+  Huffman lit{};
+  Huffman dist{};
+  std::vector<uint8_t> out;
+};
+
+// ---------------------------------------------------------------- PNG
+
+struct Image {
+  int w = 0;
+  int h = 0;
+  std::vector<uint8_t> rgba;  // w * h * 4
+
+  const uint8_t* at(int x, int y) const { return &rgba[((size_t)y * w + x) * 4]; }
+};
+
+uint32_t be32(const uint8_t* p) {
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+int paeth(int a, int b, int c) {
+  const int p = a + b - c;
+  const int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+  if (pa <= pb && pa <= pc) return a;
+  return pb <= pc ? b : c;
+}
+
+Image loadPng(const std::string& path) {
+  FILE* f = fopen(path.c_str(), "rb");
+  if (!f) fail("cannot open " + path);
+  std::vector<uint8_t> file;
+  uint8_t chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) file.insert(file.end(), chunk, chunk + n);
+  fclose(f);
+
+  static const uint8_t kSig[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  if (file.size() < 8 || memcmp(file.data(), kSig, 8) != 0) fail(path + ": not a PNG file");
+
+  int w = 0, h = 0, depth = 0, colorType = 0;
+  std::vector<uint8_t> idat, plte, trns;
+  size_t pos = 8;
+  while (pos + 12 <= file.size()) {
+    const uint32_t len = be32(&file[pos]);
+    const char* type = (const char*)&file[pos + 4];
+    const uint8_t* data = &file[pos + 8];
+    if (pos + 12 + len > file.size()) fail(path + ": truncated chunk");
+    if (!memcmp(type, "IHDR", 4)) {
+      w = (int)be32(data);
+      h = (int)be32(data + 4);
+      depth = data[8];
+      colorType = data[9];
+      if (data[12] != 0) fail(path + ": interlaced PNGs are not supported");
+    } else if (!memcmp(type, "PLTE", 4)) {
+      plte.assign(data, data + len);
+    } else if (!memcmp(type, "tRNS", 4)) {
+      trns.assign(data, data + len);
+    } else if (!memcmp(type, "IDAT", 4)) {
+      idat.insert(idat.end(), data, data + len);
+    } else if (!memcmp(type, "IEND", 4)) {
+      break;
+    }
+    pos += 12 + len;
+  }
+  if (w <= 0 || h <= 0 || idat.size() < 2) fail(path + ": missing image data");
+
+  int channels = 0;
+  switch (colorType) {
+    case 0: channels = 1; break;
+    case 2: channels = 3; break;
+    case 3: channels = 1; break;
+    case 4: channels = 2; break;
+    case 6: channels = 4; break;
+    default: fail(path + ": unsupported colour type");
+  }
+  const bool lowDepth = depth == 1 || depth == 2 || depth == 4;
+  if (!(depth == 8 || (lowDepth && (colorType == 0 || colorType == 3)))) {
+    fail(path + ": unsupported bit depth " + std::to_string(depth));
+  }
+
+  // Nagłówek zlib (2 bajty) pomijamy, Adler-32 na końcu też.
+  Inflater inf(idat.data() + 2, idat.size() - 2);
+  std::vector<uint8_t> raw = inf.run();
+
+  const size_t bitsPerPixel = (size_t)channels * depth;
+  const size_t stride = (w * bitsPerPixel + 7) / 8;
+  const size_t bpp = bitsPerPixel >= 8 ? bitsPerPixel / 8 : 1;
+  if (raw.size() < (stride + 1) * h) fail(path + ": image data too short");
+
+  std::vector<uint8_t> prev(stride, 0), cur(stride);
+  Image img;
+  img.w = w;
+  img.h = h;
+  img.rgba.resize((size_t)w * h * 4);
+  for (int y = 0; y < h; y++) {
+    const uint8_t filter = raw[y * (stride + 1)];
+    const uint8_t* line = &raw[y * (stride + 1) + 1];
+    for (size_t i = 0; i < stride; i++) {
+      const int a = i >= bpp ? cur[i - bpp] : 0;
+      const int b = prev[i];
+      const int c = i >= bpp ? prev[i - bpp] : 0;
+      int v = line[i];
+      switch (filter) {
+        case 0: break;
+        case 1: v += a; break;
+        case 2: v += b; break;
+        case 3: v += (a + b) / 2; break;
+        case 4: v += paeth(a, b, c); break;
+        default: fail(path + ": invalid filter");
+      }
+      cur[i] = (uint8_t)v;
+    }
+
+    for (int x = 0; x < w; x++) {
+      uint8_t* px = &img.rgba[((size_t)y * w + x) * 4];
+      int sample = 0;
+      if (lowDepth) {
+        const size_t bit = (size_t)x * depth;
+        sample = (cur[bit / 8] >> (8 - depth - (bit % 8))) & ((1 << depth) - 1);
+      }
+      switch (colorType) {
+        case 0: {
+          const int g = lowDepth ? sample * 255 / ((1 << depth) - 1) : cur[x];
+          const int rawG = lowDepth ? sample : cur[x];
+          px[0] = px[1] = px[2] = (uint8_t)g;
+          px[3] = (trns.size() >= 2 && rawG == ((trns[0] << 8) | trns[1])) ? 0 : 255;
+          break;
+        }
+        case 2:
+          memcpy(px, &cur[x * 3], 3);
+          px[3] = (trns.size() >= 6 && cur[x * 3] == trns[1] && cur[x * 3 + 1] == trns[3] &&
+                   cur[x * 3 + 2] == trns[5])
+                    ? 0
+                    : 255;
+          break;
+        case 3: {
+          const int idx = lowDepth ? sample : cur[x];
+          if ((size_t)idx * 3 + 2 >= plte.size()) fail(path + ": palette index out of range");
+          memcpy(px, &plte[idx * 3], 3);
+          px[3] = (size_t)idx < trns.size() ? trns[idx] : 255;
+          break;
+        }
+        case 4:
+          px[0] = px[1] = px[2] = cur[x * 2];
+          px[3] = cur[x * 2 + 1];
+          break;
+        case 6:
+          memcpy(px, &cur[x * 4], 4);
+          break;
+      }
+    }
+    prev.swap(cur);
+  }
+  return img;
+}
+
+// ---------------------------------------------------------------- analysis
+
+uint16_t to565(const uint8_t* p) {
+  return (uint16_t)(((p[0] & 0xF8) << 8) | ((p[1] & 0xFC) << 3) | (p[2] >> 3));
+}
+
+enum class Format { Auto, Rgb565, Spans, Indexed8, Indexed4 };
+enum class Mask { Auto, None, M1, M4 };
+
+struct Options {
+  std::string name;
+  Format format = Format::Auto;
+  bool preferSize = false;
+  Mask mask = Mask::Auto;
+  bool hasKey = false;
+  uint32_t keyRgb = 0;
+  int anchorX = 0;
+  int anchorY = 0;
+  int frames = 1;
+  bool collision = false;
+  int gridW = 0;
+  int gridH = 0;
+};
+
+struct Candidate {
+  const char* label;
+  size_t bytes;
+  uint32_t cost;  // estimated cycles per full blit of one frame
+  bool usable;
+};
+
+// Model kosztu (cykle Cortex-M na piksel/odcinek) - tylko do porównań względnych.
+constexpr uint32_t kCostKeyPixel = 4;      // load, compare with key, store
+constexpr uint32_t kCostSpanPixel = 1;     // memcpy
+constexpr uint32_t kCostSpanRun = 12;      // clip + call
+constexpr uint32_t kCostSpanRow = 6;
+constexpr uint32_t kCostMask1Pixel = 7;
+constexpr uint32_t kCostMask4Pixel = 8;
+constexpr uint32_t kCostBlendPixel = 18;   // partial alpha
+
+struct Asset {
+  Options opt;
+  std::string source;
+  int w = 0;         // frame width
+  int h = 0;
+  int frames = 1;
+  bool keyed = false;
+  uint16_t key = 0;
+  Mask mask = Mask::None;
+  Format format = Format::Rgb565;
+
+  std::vector<uint16_t> pixels;   // frames * w * h
+  std::vector<uint8_t> alpha;     // 0..255, same layout
+  std::vector<uint16_t> palette;
+  std::vector<uint8_t> indices;
+  std::vector<uint16_t> spans;
+  std::vector<uint8_t> alphaMask;
+  std::vector<uint8_t> collisionMask;
+
+  size_t opaque = 0;
+  size_t partial = 0;
+  size_t runs = 0;
+  std::vector<Candidate> candidates;
+
+  bool blob = false;
+  std::vector<uint8_t> raw;
+};
+
+std::string identifier(const std::string& stem) {
+  std::string out;
+  bool upper = true;
+  for (char c : stem) {
+    if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')) {
+      out += upper && c >= 'a' && c <= 'z' ? (char)(c - 'a' + 'A') : c;
+      upper = false;
+    } else {
+      upper = true;
+    }
+  }
+  if (out.empty() || (out[0] >= '0' && out[0] <= '9')) out = "Asset" + out;
+  return out;
+}
+
+std::string stemOf(const std::string& path) {
+  size_t slash = path.find_last_of("/\\");
+  std::string base = slash == std::string::npos ? path : path.substr(slash + 1);
+  size_t dot = base.find_last_of('.');
+  return dot == std::string::npos ? base : base.substr(0, dot);
+}
+
+void buildSpans(Asset& a) {
+  // Tylko dla jednej klatki; przesunięcia liczone od początku tablicy.
+  a.spans.assign(a.h + 1, 0);
+  a.runs = 0;
+  for (int y = 0; y < a.h; y++) {
+    a.spans[y] = (uint16_t)a.spans.size();
+    int x = 0;
+    while (x < a.w) {
+      while (x < a.w && !a.alpha[y * a.w + x]) x++;
+      const int start = x;
+      while (x < a.w && a.alpha[y * a.w + x]) x++;
+      if (x > start) {
+        a.spans.push_back((uint16_t)start);
+        a.spans.push_back((uint16_t)(x - start));
+        a.runs++;
+      }
+    }
+  }
+  a.spans[a.h] = (uint16_t)a.spans.size();
+  if (a.spans.size() > 0xFFFF) a.spans.clear();
+}
+
+void buildMask(Asset& a, Mask m, std::vector<uint8_t>& out) {
+  const int rows = a.h * a.frames;
+  if (m == Mask::M1) {
+    const int stride = (a.w + 7) / 8;
+    out.assign((size_t)stride * rows, 0);
+    for (int y = 0; y < rows; y++) {
+      for (int x = 0; x < a.w; x++) {
+        if (a.alpha[(size_t)y * a.w + x] >= 128) out[y * stride + x / 8] |= (uint8_t)(0x80u >> (x & 7));
+      }
+    }
+  } else {
+    const int stride = (a.w + 1) / 2;
+    out.assign((size_t)stride * rows, 0);
+    for (int y = 0; y < rows; y++) {
+      for (int x = 0; x < a.w; x++) {
+        const uint8_t a4 = (uint8_t)((a.alpha[(size_t)y * a.w + x] + 8) / 17);
+        out[y * stride + x / 2] |= (x & 1) ? a4 : (uint8_t)(a4 << 4);
+      }
+    }
+  }
+}
+
+Asset analyse(const Image& img, const Options& opt, const std::string& path) {
+  Asset a;
+  a.opt = opt;
+  a.source = path;
+  a.frames = opt.frames > 0 ? opt.frames : 1;
+  if (img.w % a.frames) fail(path + ": width is not a multiple of --frames");
+  a.w = img.w / a.frames;
+  a.h = img.h;
+
+  // Klatki z paska poziomego układamy jedna za drugą (układ SpriteSheet).
+  const size_t n = (size_t)a.w * a.h * a.frames;
+  a.pixels.resize(n);
+  a.alpha.resize(n);
+  bool anyAlpha = false;
+  for (int f = 0; f < a.frames; f++) {
+    for (int y = 0; y < a.h; y++) {
+      for (int x = 0; x < a.w; x++) {
+        const uint8_t* p = img.at(f * a.w + x, y);
+        const size_t i = ((size_t)f * a.h + y) * a.w + x;
+        uint8_t al = p[3];
+        if (opt.hasKey && ((uint32_t)p[0] << 16 | (uint32_t)p[1] << 8 | p[2]) == opt.keyRgb) al = 0;
+        a.pixels[i] = to565(p);
+        a.alpha[i] = al;
+        if (al != 255) anyAlpha = true;
+        if (al >= 128) a.opaque++;
+        if (al > 8 && al < 247) a.partial++;
+      }
+    }
+  }
+
+  a.mask = opt.mask;
+  if (a.mask == Mask::Auto) a.mask = a.partial ? Mask::M4 : Mask::None;
+  a.keyed = anyAlpha;
+
+  if (a.keyed) {
+    // Klucz: kolor nieużywany przez żaden widoczny piksel (najpierw magenta).
+    std::vector<bool> used(65536, false);
+    for (size_t i = 0; i < n; i++) {
+      if (a.alpha[i] >= (a.mask == Mask::M4 ? 9 : 128)) used[a.pixels[i]] = true;
+    }
+    uint32_t k = 0xF81F;
+    if (used[k]) {
+      for (k = 0; k < 65536 && used[k]; k++) {
+      }
+      if (k == 65536) fail(path + ": no free colour for the transparent key");
+    }
+    a.key = (uint16_t)k;
+    const int threshold = a.mask == Mask::M4 ? 9 : 128;
+    for (size_t i = 0; i < n; i++) {
+      if (a.alpha[i] < threshold) a.pixels[i] = a.key;
+    }
+    // Dalsze liczenie odcinków na tej samej granicy widoczności.
+    for (size_t i = 0; i < n; i++) a.alpha[i] = a.alpha[i] >= threshold ? (a.alpha[i] ? a.alpha[i] : 1) : 0;
+  }
+
+  // Paleta (z kluczem jako zwykłym kolorem).
+  std::map<uint16_t, uint8_t> lookup;
+  bool paletteFits = true;
+  for (size_t i = 0; i < n && paletteFits; i++) {
+    if (lookup.count(a.pixels[i])) continue;
+    if (lookup.size() == 256) {
+      paletteFits = false;
+      break;
+    }
+    lookup[a.pixels[i]] = (uint8_t)lookup.size();
+  }
+  if (paletteFits) {
+    a.palette.resize(lookup.size());
+    for (auto& kv : lookup) a.palette[kv.second] = kv.first;
+  }
+
+  const bool singleFrame = a.frames == 1;
+  if (a.keyed && singleFrame && a.mask == Mask::None) buildSpans(a);
+
+  // Kandydaci: rozmiar i koszt blitu jednej klatki.
+  const size_t fp = (size_t)a.w * a.h;
+  const size_t maskBytes = a.mask == Mask::M1 ? (size_t)((a.w + 7) / 8) * a.h * a.frames
+                           : a.mask == Mask::M4 ? (size_t)((a.w + 1) / 2) * a.h * a.frames
+                                                : 0;
+  uint32_t pixelCost = kCostKeyPixel;
+  if (a.mask == Mask::M1) pixelCost = kCostMask1Pixel;
+  if (a.mask == Mask::M4) pixelCost = kCostMask4Pixel;
+  const uint32_t blitCost =
+    (uint32_t)(fp * pixelCost + (a.mask == Mask::M4 ? (a.partial / a.frames) * (kCostBlendPixel - kCostMask4Pixel) : 0));
+
+  a.candidates.push_back({"rgb565", n * 2 + maskBytes, blitCost, true});
+  a.candidates.push_back({"spans", n * 2 + a.spans.size() * 2,
+                          (uint32_t)(a.opaque * kCostSpanPixel + a.runs * kCostSpanRun + a.h * kCostSpanRow),
+                          !a.spans.empty()});
+  a.candidates.push_back({"indexed8", n + a.palette.size() * 2 + maskBytes, blitCost, paletteFits});
+  a.candidates.push_back({"indexed4", (size_t)((a.w + 1) / 2) * a.h * a.frames + a.palette.size() * 2 + maskBytes,
+                          blitCost, paletteFits && a.palette.size() <= 16});
+
+  // Wybór formatu.
+  auto usable = [&](const char* label) {
+    for (auto& c : a.candidates) {
+      if (!strcmp(c.label, label)) return c.usable;
+    }
+    return false;
+  };
+  Format f = opt.format;
+  if (f == Format::Auto) {
+    if (opt.preferSize) {
+      f = usable("indexed4") ? Format::Indexed4 : usable("indexed8") ? Format::Indexed8 : Format::Rgb565;
+    } else {
+      f = (usable("spans") && a.candidates[1].cost < a.candidates[0].cost) ? Format::Spans : Format::Rgb565;
+    }
+  }
+  if (f == Format::Spans && !usable("spans")) fail(path + ": spans need a single keyed frame without mask");
+  if (f == Format::Indexed8 && !usable("indexed8")) fail(path + ": more than 256 colours");
+  if (f == Format::Indexed4 && !usable("indexed4")) fail(path + ": more than 16 colours");
+  a.format = f;
+
+  if (f == Format::Indexed8) {
+    a.indices.resize(n);
+    for (size_t i = 0; i < n; i++) a.indices[i] = lookup[a.pixels[i]];
+  } else if (f == Format::Indexed4) {
+    const int stride = (a.w + 1) / 2;
+    const int rows = a.h * a.frames;
+    a.indices.assign((size_t)stride * rows, 0);
+    for (int y = 0; y < rows; y++) {
+      for (int x = 0; x < a.w; x++) {
+        const uint8_t idx = lookup[a.pixels[(size_t)y * a.w + x]];
+        a.indices[y * stride + x / 2] |= (x & 1) ? idx : (uint8_t)(idx << 4);
+      }
+    }
+  }
+  if (f != Format::Spans) a.spans.clear();
+  if (a.mask != Mask::None) buildMask(a, a.mask, a.alphaMask);
+  if (opt.collision) buildMask(a, Mask::M1, a.collisionMask);
+  return a;
+}
+
+Asset loadBlob(const std::string& path, const Options& opt) {
+  FILE* f = fopen(path.c_str(), "rb");
+  if (!f) fail("cannot open " + path);
+  Asset a;
+  a.opt = opt;
+  a.source = path;
+  a.blob = true;
+  a.w = opt.gridW;
+  a.h = opt.gridH;
+  uint8_t chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) a.raw.insert(a.raw.end(), chunk, chunk + n);
+  fclose(f);
+  return a;
+}
+
+// ---------------------------------------------------------------- output
+
+template <class T>
+void writeArray(FILE* f, const char* type, const std::string& name, const std::vector<T>& v, bool hex16) {
+  fprintf(f, "inline constexpr %s %s[] = {", type, name.c_str());
+  for (size_t i = 0; i < v.size(); i++) {
+    if (i % 12 == 0) fprintf(f, "\n   ");
+    if (hex16) {
+      fprintf(f, " 0x%04X,", (unsigned)v[i]);
+    } else {
+      fprintf(f, " 0x%02X,", (unsigned)v[i]);
+    }
+  }
+  fprintf(f, "\n};\n");
+}
+
+const char* formatName(Format f) {
+  switch (f) {
+    case Format::Spans: return "spans";
+    case Format::Indexed8: return "indexed8";
+    case Format::Indexed4: return "indexed4";
+    default: return "rgb565";
+  }
+}
+
+void writeAsset(FILE* f, const Asset& a) {
+  const std::string k = "k" + a.opt.name;
+  if (a.blob) {
+    fprintf(f, "\n// %s: %zu bytes, %dx%d\n", a.source.c_str(), a.raw.size(), a.w, a.h);
+    writeArray(f, "uint8_t", k, a.raw, false);
+    return;
+  }
+  fprintf(f, "\n// %s: %dx%d, %d frame(s), %s\n", a.source.c_str(), a.w, a.h, a.frames, formatName(a.format));
+
+  const bool indexed = a.format == Format::Indexed8 || a.format == Format::Indexed4;
+  if (indexed) {
+    writeArray(f, "uint16_t", k + "Palette", a.palette, true);
+    writeArray(f, "uint8_t", k + "Indices", a.indices, false);
+  } else {
+    writeArray(f, "uint16_t", k + "Pixels", a.pixels, true);
+  }
+  if (!a.spans.empty()) writeArray(f, "uint16_t", k + "Spans", a.spans, true);
+  if (!a.alphaMask.empty()) writeArray(f, "uint8_t", k + "AlphaMask", a.alphaMask, false);
+  if (!a.collisionMask.empty()) writeArray(f, "uint8_t", k + "Collision", a.collisionMask, false);
+
+  const char* fmt = a.format == Format::Indexed8   ? "Indexed8"
+                    : a.format == Format::Indexed4 ? "Indexed4"
+                                                   : "Rgb565";
+  const char* blend = a.mask == Mask::M1 ? "Mask1" : a.mask == Mask::M4 ? "Mask4" : "Key";
+  fprintf(f, "inline constexpr SpriteAsset %s = {\n", k.c_str());
+  fprintf(f, "    SpriteAsset::Format::%s, %d, %d, %d, %d, %d, %s, 0x%04X,\n", fmt, a.w, a.h, a.frames,
+          a.opt.anchorX, a.opt.anchorY, a.keyed ? "true" : "false", (unsigned)a.key);
+  fprintf(f, "    %s, %s, %s, %u,\n", indexed ? "nullptr" : (k + "Pixels").c_str(),
+          indexed ? (k + "Indices").c_str() : "nullptr", indexed ? (k + "Palette").c_str() : "nullptr",
+          indexed ? (unsigned)a.palette.size() : 0u);
+  fprintf(f, "    %s, SpriteLayer::Blend::%s, %s, %s,\n};\n", a.spans.empty() ? "nullptr" : (k + "Spans").c_str(),
+          blend, a.alphaMask.empty() ? "nullptr" : (k + "AlphaMask").c_str(),
+          a.collisionMask.empty() ? "nullptr" : (k + "Collision").c_str());
+}
+
+void report(const Asset& a) {
+  if (a.blob) {
+    printf("%-16s %4dx%-4d data %zu B\n", a.opt.name.c_str(), a.w, a.h, a.raw.size());
+    return;
+  }
+  printf("%-16s %4dx%-4d x%-2d opaque=%-6zu runs=%-5zu colours=%-4s mask=%s\n", a.opt.name.c_str(), a.w, a.h,
+         a.frames, a.opaque, a.runs, a.palette.empty() ? ">256" : std::to_string(a.palette.size()).c_str(),
+         a.mask == Mask::M1 ? "1" : a.mask == Mask::M4 ? "4" : "none");
+  for (const Candidate& c : a.candidates) {
+    const bool chosen = !strcmp(c.label, formatName(a.format));
+    if (!c.usable) {
+      printf("    %-9s  n/a\n", c.label);
+      continue;
+    }
+    printf("  %c %-9s %7zu B  ~%u cycles/blit%s\n", chosen ? '*' : ' ', c.label, c.bytes, c.cost,
+           (!strcmp(c.label, "indexed8") || !strcmp(c.label, "indexed4")) ? " after decode()" : "");
+  }
+}
+
+// ---------------------------------------------------------------- pack
+
+void put16(std::vector<uint8_t>& v, uint32_t x) {
+  v.push_back((uint8_t)x);
+  v.push_back((uint8_t)(x >> 8));
+}
+
+void put32(std::vector<uint8_t>& v, uint32_t x) {
+  put16(v, x & 0xFFFF);
+  put16(v, x >> 16);
+}
+
+// Stored bytes of one asset in the AssetStore pack layout.
+std::vector<uint8_t> packData(const Asset& a, uint32_t* decodedBytes) {
+  std::vector<uint8_t> d;
+  if (a.blob) {
+    *decodedBytes = (uint32_t)a.raw.size();
+    return a.raw;
+  }
+  const bool indexed = a.format == Format::Indexed8 || a.format == Format::Indexed4;
+  if (indexed) {
+    for (uint16_t c : a.palette) put16(d, c);
+    d.insert(d.end(), a.indices.begin(), a.indices.end());
+  } else {
+    for (uint16_t c : a.pixels) put16(d, c);
+  }
+  d.insert(d.end(), a.alphaMask.begin(), a.alphaMask.end());
+  for (uint16_t v : a.spans) put16(d, v);
+  *decodedBytes = (uint32_t)(a.pixels.size() * 2 + a.alphaMask.size() + a.spans.size() * 2);
+  return d;
+}
+
+void writePack(const std::string& path, const std::vector<Asset>& assets, std::vector<uint32_t>& sizes) {
+  constexpr uint32_t kHeader = 16;
+  constexpr uint32_t kEntry = 32;
+  if (assets.size() > 0xFFFF) fail("too many assets for one pack");
+
+  std::vector<uint8_t> dir, body;
+  uint32_t offset = kHeader + (uint32_t)assets.size() * kEntry;
+  for (const Asset& a : assets) {
+    uint32_t decoded = 0;
+    const std::vector<uint8_t> d = packData(a, &decoded);
+    sizes.push_back((uint32_t)d.size());
+    const bool indexed = a.format == Format::Indexed8 || a.format == Format::Indexed4;
+    put32(dir, offset);
+    put32(dir, (uint32_t)d.size());
+    put32(dir, decoded);
+    put16(dir, (uint32_t)a.w);
+    put16(dir, (uint32_t)a.h);
+    put16(dir, (uint32_t)a.frames);
+    put16(dir, (uint16_t)a.opt.anchorX);
+    put16(dir, (uint16_t)a.opt.anchorY);
+    put16(dir, a.key);
+    put16(dir, indexed && !a.blob ? (uint32_t)a.palette.size() : 0u);
+    put16(dir, (uint32_t)a.spans.size() * 2);
+    dir.push_back(a.blob ? 1 : 0);
+    dir.push_back(a.format == Format::Indexed8 ? 1 : a.format == Format::Indexed4 ? 2 : 0);
+    dir.push_back(a.blob ? 0 : a.mask == Mask::M1 ? 1 : a.mask == Mask::M4 ? 2 : 0);
+    dir.push_back(a.keyed ? 1 : 0);
+
+    body.insert(body.end(), d.begin(), d.end());
+    offset += (uint32_t)d.size();
+    // Każdy zasób od granicy 4 bajtów.
+    while (offset & 3) {
+      body.push_back(0);
+      offset++;
+    }
+  }
+
+  std::vector<uint8_t> header = {'S', 'G', 'F', 'P'};
+  put16(header, 1);
+  put16(header, (uint32_t)assets.size());
+  put32(header, kHeader);
+  put32(header, 0);
+
+  FILE* f = fopen(path.c_str(), "wb");
+  if (!f) fail("cannot write " + path);
+  fwrite(header.data(), 1, header.size(), f);
+  fwrite(dir.data(), 1, dir.size(), f);
+  fwrite(body.data(), 1, body.size(), f);
+  fclose(f);
+}
+
+Format parseFormat(const std::string& s) {
+  if (s == "auto") return Format::Auto;
+  if (s == "rgb565") return Format::Rgb565;
+  if (s == "spans") return Format::Spans;
+  if (s == "indexed8") return Format::Indexed8;
+  if (s == "indexed4") return Format::Indexed4;
+  fail("unknown format " + s);
+}
+
+Mask parseMask(const std::string& s) {
+  if (s == "auto") return Mask::Auto;
+  if (s == "none") return Mask::None;
+  if (s == "1") return Mask::M1;
+  if (s == "4") return Mask::M4;
+  fail("unknown mask " + s);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string output;
+  std::string ns;
+  std::string pack;
+  Options opt;
+  std::vector<Asset> assets;
+
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    auto value = [&]() -> std::string {
+      if (i + 1 >= argc) fail("missing value for " + arg);
+      return argv[++i];
+    };
+    if (arg == "-o") {
+      output = value();
+    } else if (arg == "--namespace") {
+      ns = value();
+    } else if (arg == "--pack") {
+      pack = value();
+    } else if (arg == "--name") {
+      opt.name = value();
+    } else if (arg == "--format") {
+      opt.format = parseFormat(value());
+    } else if (arg == "--prefer") {
+      const std::string p = value();
+      if (p != "speed" && p != "size") fail("--prefer takes speed or size");
+      opt.preferSize = p == "size";
+    } else if (arg == "--mask") {
+      opt.mask = parseMask(value());
+    } else if (arg == "--key") {
+      opt.hasKey = true;
+      opt.keyRgb = (uint32_t)strtoul(value().c_str(), nullptr, 16);
+    } else if (arg == "--anchor") {
+      if (sscanf(value().c_str(), "%d,%d", &opt.anchorX, &opt.anchorY) != 2) fail("--anchor takes X,Y");
+    } else if (arg == "--frames") {
+      opt.frames = atoi(value().c_str());
+    } else if (arg == "--collision") {
+      opt.collision = true;
+    } else if (arg == "--grid") {
+      if (sscanf(value().c_str(), "%d,%d", &opt.gridW, &opt.gridH) != 2) fail("--grid takes W,H");
+    } else if (!arg.empty() && arg[0] == '-') {
+      fail("unknown option " + arg);
+    } else {
+      Options o = opt;
+      o.name = identifier(opt.name.empty() ? stemOf(arg) : opt.name);
+      const bool png = arg.size() > 4 && arg.compare(arg.size() - 4, 4, ".png") == 0;
+      assets.push_back(png ? analyse(loadPng(arg), o, arg) : loadBlob(arg, o));
+      opt.name.clear();
+    }
+  }
+  if (output.empty() || assets.empty()) {
+    fprintf(stderr, "usage: sgfasset [options] -o assets.h image.png ...\n");
+    return 2;
+  }
+
+  std::vector<uint32_t> packSizes;
+  if (!pack.empty()) writePack(pack, assets, packSizes);
+
+  FILE* f = fopen(output.c_str(), "w");
+  if (!f) fail("cannot write " + output);
+  fprintf(f, "// Generated by sgfasset - do not edit.\n#pragma once\n\n#include \"SGF/%s\"\n",
+          pack.empty() ? "SpriteAsset.h" : "AssetStore.h");
+  if (!ns.empty()) fprintf(f, "\nnamespace %s {\n", ns.c_str());
+  if (pack.empty()) {
+    for (const Asset& a : assets) writeAsset(f, a);
+  } else {
+    const size_t slash = pack.find_last_of("/\\");
+    fprintf(f, "\n// Handles into %s.\n", (slash == std::string::npos ? pack : pack.substr(slash + 1)).c_str());
+    for (size_t i = 0; i < assets.size(); i++) {
+      const Asset& a = assets[i];
+      fprintf(f, "inline constexpr AssetHandle k%s = %zu;  // %s, %dx%d, %u B\n", a.opt.name.c_str(), i,
+              a.blob ? "data" : formatName(a.format), a.w, a.h, packSizes[i]);
+    }
+    fprintf(f, "inline constexpr int kAssetCount = %zu;\n", assets.size());
+  }
+  if (!ns.empty()) fprintf(f, "\n}  // namespace %s\n", ns.c_str());
+  fclose(f);
+
+  for (const Asset& a : assets) report(a);
+  return 0;
+}